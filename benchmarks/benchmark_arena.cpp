@@ -0,0 +1,117 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Allocates 1M 24 byte nodes, and 1M arrays of 1 to 8 uint32_t, from a 64MB buffer with
+// verified_arena and with a bump allocator which does not check its size arithmetic.
+// Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_arena.cpp -lbenchmark -lpthread
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_arena.hpp"
+
+namespace {
+
+std::size_t const allocation_count = 1000000;
+
+struct node
+{
+    node *next;
+    uint64_t key;
+    uint64_t value;
+};
+
+class unchecked_arena
+{
+public:
+    unchecked_arena(void *const buffer, std::size_t const capacity) :
+        first_(static_cast<char *>(buffer)), position_(first_), last_(first_ + capacity)
+    {
+    }
+
+    template <typename T>
+    T *allocate(std::size_t const count)
+    {
+        std::size_t const alignment = boost::alignment_of<T>::value;
+        char *const aligned = reinterpret_cast<char *>(
+            (reinterpret_cast<uintptr_t>(position_) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+        if (count * sizeof(T) > static_cast<std::size_t>(last_ - aligned)) {
+            return 0;
+        }
+        position_ = aligned + count * sizeof(T);
+        return reinterpret_cast<T *>(aligned);
+    }
+
+    void reset()
+    {
+        position_ = first_;
+    }
+
+private:
+    char *first_;
+    char *position_;
+    char *last_;
+};
+
+std::vector<uint64_t> &buffer()
+{
+    static std::vector<uint64_t> words(8 * 1024 * 1024);
+    return words;
+}
+
+std::vector<std::size_t> const &counts()
+{
+    static std::vector<std::size_t> sizes;
+    if (sizes.empty()) {
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < allocation_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            sizes.push_back(1 + (state >> 40) % 8);
+        }
+    }
+    return sizes;
+}
+
+template <class Arena>
+void Nodes(benchmark::State &state)
+{
+    Arena arena(&buffer()[0], buffer().size() * sizeof(uint64_t));
+    for (auto _ : state) {
+        arena.reset();
+        node *previous = 0;
+        for (std::size_t i = 0; i < allocation_count; ++i) {
+            node *const allocated = arena.template allocate<node>(1);
+            allocated->next = previous;
+            previous = allocated;
+        }
+        benchmark::DoNotOptimize(previous);
+    }
+    state.SetItemsProcessed(state.iterations() * allocation_count);
+}
+
+template <class Arena>
+void Arrays(benchmark::State &state)
+{
+    std::vector<std::size_t> const &sizes = counts();
+    Arena arena(&buffer()[0], buffer().size() * sizeof(uint64_t));
+    for (auto _ : state) {
+        arena.reset();
+        for (std::size_t i = 0; i < allocation_count; ++i) {
+            uint32_t *const allocated = arena.template allocate<uint32_t>(sizes[i]);
+            allocated[0] = static_cast<uint32_t>(i);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * allocation_count);
+}
+
+BENCHMARK_TEMPLATE(Nodes, boost::verified_arena);
+BENCHMARK_TEMPLATE(Nodes, unchecked_arena);
+BENCHMARK_TEMPLATE(Arrays, boost::verified_arena);
+BENCHMARK_TEMPLATE(Arrays, unchecked_arena);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
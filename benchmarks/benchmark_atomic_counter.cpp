@@ -0,0 +1,54 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Increments one shared counter from 1 to N threads, where N is the number of hardware
+// threads, with atomic_verified_int and with a verified_int behind a mutex.  Build with
+// Google Benchmark:
+//
+//     g++ -std=c++11 -O2 -I.. benchmark_atomic_counter.cpp -lbenchmark -lpthread
+
+#include <mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "verified_int_atomic.hpp"
+
+namespace {
+
+int const max_threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+template <class Policy>
+void BM_increment_atomic(benchmark::State &state)
+{
+    static boost::atomic_verified_int<uint64_t, Policy> counter;
+    for (auto _ : state) {
+        counter.fetch_add(1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Policy>
+void BM_increment_mutex(benchmark::State &state)
+{
+    static std::mutex mutex;
+    static boost::verified_int<uint64_t, Policy> counter;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> const lock(mutex);
+        counter += 1U;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A single fetch_add.
+BENCHMARK_TEMPLATE(BM_increment_atomic, boost::ignore_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_increment_mutex, boost::ignore_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+// A compare_exchange_weak loop.
+BENCHMARK_TEMPLATE(BM_increment_atomic, boost::saturate_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_increment_mutex, boost::saturate_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+// A single fetch_add, then a check.
+BENCHMARK_TEMPLATE(BM_increment_atomic, boost::sticky_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_increment_mutex, boost::sticky_overflow)->ThreadRange(1, max_threads)->UseRealTime();
+} // namespace anonymous
+
+BENCHMARK_MAIN();
@@ -0,0 +1,205 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Parses 1M decimal numbers of each of the eight integer types, spread over the range of
+// the type, with verified_from_chars, std::from_chars, and strtoll followed by constructing
+// a verified_int.  Writes them back with verified_to_chars, std::to_chars and snprintf, and
+// to a std::ostream with and without verified_int_io.hpp.
+// Build with Google Benchmark, in C++17 for std::from_chars and std::to_chars:
+//
+//     g++ -std=c++17 -O2 -I.. benchmark_charconv.cpp -lbenchmark -lpthread
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_charconv.hpp"
+#include "verified_int_io.hpp"
+
+namespace {
+
+std::size_t const number_count = 1000000;
+
+// The numbers, separated by spaces.
+template <typename T>
+std::string const &numbers()
+{
+    static std::string text;
+    if (text.empty()) {
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < number_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            // Shifting by a random amount spreads the lengths of the numbers, which stay in
+            // the range of strtoll.
+            T const value = static_cast<T>(static_cast<T>(state) >> (1 + (state >> 58) % (8 * sizeof(T) - 1)));
+            text += std::to_string(static_cast<long long>(value));
+            text += ' ';
+        }
+    }
+    return text;
+}
+
+template <typename T>
+void BM_verified_from_chars(benchmark::State &state)
+{
+    std::string const &text = numbers<T>();
+    for (auto _ : state) {
+        char const *position = text.data();
+        char const *const last = text.data() + text.size();
+        boost::verified_int<T, boost::throw_overflow> value;
+        while (position != last) {
+            position = boost::verified_from_chars(position, last, value).ptr + 1;
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_std_from_chars(benchmark::State &state)
+{
+    std::string const &text = numbers<T>();
+    for (auto _ : state) {
+        char const *position = text.data();
+        char const *const last = text.data() + text.size();
+        T value;
+        while (position != last) {
+            position = std::from_chars(position, last, value).ptr + 1;
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_strtoll(benchmark::State &state)
+{
+    std::string const &text = numbers<T>();
+    for (auto _ : state) {
+        char const *position = text.data();
+        char const *const last = text.data() + text.size();
+        while (position != last) {
+            char *end;
+            boost::verified_int<T, boost::throw_overflow> const value(static_cast<int64_t>(std::strtoll(position, &end, 10)));
+            benchmark::DoNotOptimize(value);
+            position = end + 1;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+// The numbers, parsed.
+template <typename T>
+std::vector<T> const &values()
+{
+    static std::vector<T> parsed;
+    if (parsed.empty()) {
+        std::string const &text = numbers<T>();
+        char const *position = text.data();
+        char const *const last = text.data() + text.size();
+        while (position != last) {
+            T value;
+            position = std::from_chars(position, last, value).ptr + 1;
+            parsed.push_back(value);
+        }
+    }
+    return parsed;
+}
+
+template <typename T>
+void BM_verified_to_chars(benchmark::State &state)
+{
+    std::vector<T> const &numbers = values<T>();
+    char buffer[boost::verified_chars<T>::size];
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            boost::verified_int<T, boost::throw_overflow> const value(numbers[i]);
+            benchmark::DoNotOptimize(boost::verified_to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_std_to_chars(benchmark::State &state)
+{
+    std::vector<T> const &numbers = values<T>();
+    char buffer[boost::verified_chars<T>::size];
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            benchmark::DoNotOptimize(std::to_chars(buffer, buffer + sizeof(buffer), numbers[i]).ptr);
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_snprintf(benchmark::State &state)
+{
+    std::vector<T> const &numbers = values<T>();
+    char buffer[32];
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            benchmark::DoNotOptimize(std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(numbers[i])));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_verified_ostream(benchmark::State &state)
+{
+    std::vector<T> const &numbers = values<T>();
+    std::ostringstream out;
+    for (auto _ : state) {
+        out.seekp(0);
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            out << boost::verified_int<T, boost::throw_overflow>(numbers[i]) << ' ';
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+template <typename T>
+void BM_builtin_ostream(benchmark::State &state)
+{
+    std::vector<T> const &numbers = values<T>();
+    std::ostringstream out;
+    for (auto _ : state) {
+        out.seekp(0);
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            out << static_cast<long long>(numbers[i]) << ' ';
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * number_count);
+}
+
+#define GEN_BENCHMARKS(TYPE) \
+    BENCHMARK_TEMPLATE(BM_verified_from_chars, TYPE); \
+    BENCHMARK_TEMPLATE(BM_std_from_chars, TYPE); \
+    BENCHMARK_TEMPLATE(BM_strtoll, TYPE); \
+    BENCHMARK_TEMPLATE(BM_verified_to_chars, TYPE); \
+    BENCHMARK_TEMPLATE(BM_std_to_chars, TYPE); \
+    BENCHMARK_TEMPLATE(BM_snprintf, TYPE);
+GEN_BENCHMARKS(uint8_t)
+GEN_BENCHMARKS(uint16_t)
+GEN_BENCHMARKS(uint32_t)
+GEN_BENCHMARKS(uint64_t)
+GEN_BENCHMARKS(int8_t)
+GEN_BENCHMARKS(int16_t)
+GEN_BENCHMARKS(int32_t)
+GEN_BENCHMARKS(int64_t)
+#undef GEN_BENCHMARKS
+BENCHMARK_TEMPLATE(BM_verified_ostream, int64_t);
+BENCHMARK_TEMPLATE(BM_builtin_ostream, int64_t);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
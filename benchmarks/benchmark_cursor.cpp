@@ -0,0 +1,90 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Parses 100000 length-prefixed records, each a big endian uint16_t type, a big endian
+// uint32_t length and a body of up to 64 bytes of which the first two are a uint16_t, with
+// verified_cursor and with a hand-written reader which does not check the lengths.
+// Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_cursor.cpp -lbenchmark -lpthread
+
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_cursor.hpp"
+#include "verified_int_endian.hpp"
+
+namespace {
+
+std::size_t const record_count = 100000;
+
+std::vector<unsigned char> const &records()
+{
+    static std::vector<unsigned char> bytes;
+    if (bytes.empty()) {
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint32_t const length = static_cast<uint32_t>(2 + (state >> 40) % 63);
+            boost::be_field<uint16_t> type;
+            type.store(static_cast<uint16_t>(state >> 20));
+            boost::be_field<uint32_t> prefix;
+            prefix.store(length);
+            bytes.insert(bytes.end(), type.bytes, type.bytes + sizeof(type));
+            bytes.insert(bytes.end(), prefix.bytes, prefix.bytes + sizeof(prefix));
+            for (uint32_t j = 0; j < length; ++j) {
+                bytes.push_back(static_cast<unsigned char>(state >> (j % 32)));
+            }
+        }
+    }
+    return bytes;
+}
+
+void VerifiedCursor(benchmark::State &state)
+{
+    std::vector<unsigned char> const &bytes = records();
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        boost::verified_cursor<boost::throw_overflow> cursor(&bytes[0], bytes.size());
+        while (!cursor.empty()) {
+            sum += cursor.read<boost::be_field<uint16_t> >().value();
+            uint32_t const length = cursor.read<boost::be_field<uint32_t> >().value();
+            boost::verified_cursor<boost::throw_overflow> body = cursor.subspan(length);
+            sum += body.read<uint16_t>();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * record_count);
+}
+
+void UncheckedReader(benchmark::State &state)
+{
+    std::vector<unsigned char> const &bytes = records();
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        unsigned char const *position = &bytes[0];
+        unsigned char const *const end = position + bytes.size();
+        while (position != end) {
+            uint16_t type;
+            std::memcpy(&type, position, sizeof(type));
+            sum += boost::endian::big_to_native(type);
+            uint32_t length;
+            std::memcpy(&length, position + 2, sizeof(length));
+            unsigned char const *const body = position + 6;
+            position = body + boost::endian::big_to_native(length);
+            uint16_t first;
+            std::memcpy(&first, body, sizeof(first));
+            sum += first;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * record_count);
+}
+
+BENCHMARK(VerifiedCursor);
+BENCHMARK(UncheckedReader);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
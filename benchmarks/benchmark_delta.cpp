@@ -0,0 +1,101 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Decodes a column of 1M increasing int32_t and int64_t values from their deltas, in blocks
+// of 4096 as a reader of a columnar file would: with delta_decoder, with a loop of
+// verified_int<T, throw_overflow> +=, and with an unchecked prefix sum of T.
+// Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_delta.cpp -lbenchmark -lpthread
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_delta.hpp"
+
+namespace {
+
+std::size_t const value_count = 1000000;
+std::size_t const block_count = 4096;
+
+template <typename T>
+std::vector<T> const &deltas()
+{
+    static std::vector<T> column;
+    if (column.empty()) {
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < value_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            column.push_back(static_cast<T>((state >> 40) % 1000));
+        }
+    }
+    return column;
+}
+
+template <typename T>
+void DeltaDecoder(benchmark::State &state)
+{
+    std::vector<T> const &column = deltas<T>();
+    std::vector<T> values(block_count);
+    for (auto _ : state) {
+        boost::delta_decoder<T, boost::throw_overflow> decoder;
+        for (std::size_t begin = 0; begin < value_count; begin += block_count) {
+            std::size_t const size = value_count - begin < block_count ? value_count - begin : block_count;
+            decoder.decode(&values[0], &column[begin], size);
+            benchmark::ClobberMemory();
+        }
+        benchmark::DoNotOptimize(decoder.previous());
+    }
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+template <typename T>
+void VerifiedIntLoop(benchmark::State &state)
+{
+    std::vector<T> const &column = deltas<T>();
+    std::vector<T> values(block_count);
+    for (auto _ : state) {
+        boost::verified_int<T, boost::throw_overflow> running;
+        for (std::size_t begin = 0; begin < value_count; begin += block_count) {
+            std::size_t const size = value_count - begin < block_count ? value_count - begin : block_count;
+            for (std::size_t i = 0; i < size; ++i) {
+                running += column[begin + i];
+                values[i] = running;
+            }
+            benchmark::ClobberMemory();
+        }
+        benchmark::DoNotOptimize(running);
+    }
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+template <typename T>
+void UncheckedPrefixSum(benchmark::State &state)
+{
+    std::vector<T> const &column = deltas<T>();
+    std::vector<T> values(block_count);
+    for (auto _ : state) {
+        T running = 0;
+        for (std::size_t begin = 0; begin < value_count; begin += block_count) {
+            std::size_t const size = value_count - begin < block_count ? value_count - begin : block_count;
+            for (std::size_t i = 0; i < size; ++i) {
+                running += column[begin + i];
+                values[i] = running;
+            }
+            benchmark::ClobberMemory();
+        }
+        benchmark::DoNotOptimize(running);
+    }
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+BENCHMARK_TEMPLATE(DeltaDecoder, int32_t);
+BENCHMARK_TEMPLATE(VerifiedIntLoop, int32_t);
+BENCHMARK_TEMPLATE(UncheckedPrefixSum, int32_t);
+BENCHMARK_TEMPLATE(DeltaDecoder, int64_t);
+BENCHMARK_TEMPLATE(VerifiedIntLoop, int64_t);
+BENCHMARK_TEMPLATE(UncheckedPrefixSum, int64_t);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
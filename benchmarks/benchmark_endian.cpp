@@ -0,0 +1,76 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Converts 4096 big endian uint32_t fields into verified uint32_t and uint16_t, packed and
+// as one field of each of an array of 12 byte records, with the bulk verified_read and with
+// a loop that swaps the bytes of each field and constructs a verified_int from it.
+// Build with Google Benchmark, with and without SSSE3:
+//
+//     g++ -O2 -I.. benchmark_endian.cpp -lbenchmark -lpthread
+//     g++ -O2 -mssse3 -I.. benchmark_endian.cpp -lbenchmark -lpthread
+
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_endian.hpp"
+
+namespace {
+
+typedef boost::be_field<uint32_t> field;
+std::size_t const field_count = 4096;
+
+std::vector<unsigned char> const &fields(std::size_t const stride)
+{
+    static std::vector<unsigned char> bytes[2];
+    std::vector<unsigned char> &buffer = bytes[stride == sizeof(field) ? 0 : 1];
+    if (buffer.empty()) {
+        buffer.resize(field_count * stride + 1);
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < field_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            reinterpret_cast<field *>(&buffer[1 + i * stride])->store(static_cast<uint32_t>((state >> 40) % 60000));
+        }
+    }
+    return buffer;
+}
+
+template <typename V>
+void BulkRead(benchmark::State &state)
+{
+    std::size_t const stride = static_cast<std::size_t>(state.range(0));
+    std::vector<unsigned char> const &bytes = fields(stride);
+    std::vector<V> values(field_count);
+    for (auto _ : state) {
+        boost::verified_read<V, boost::throw_overflow>(&values[0], reinterpret_cast<field const *>(&bytes[1]),
+                                                       stride, field_count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * field_count);
+}
+
+template <typename V>
+void SwapLoop(benchmark::State &state)
+{
+    std::size_t const stride = static_cast<std::size_t>(state.range(0));
+    std::vector<unsigned char> const &bytes = fields(stride);
+    std::vector<V> values(field_count);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < field_count; ++i) {
+            uint32_t raw;
+            std::memcpy(&raw, &bytes[1 + i * stride], sizeof(raw));
+            values[i] = boost::verified_int<V, boost::throw_overflow>(boost::endian::big_to_native(raw));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * field_count);
+}
+
+BENCHMARK_TEMPLATE(BulkRead, uint32_t)->Arg(4)->Arg(12);
+BENCHMARK_TEMPLATE(SwapLoop, uint32_t)->Arg(4)->Arg(12);
+BENCHMARK_TEMPLATE(BulkRead, uint16_t)->Arg(4)->Arg(12);
+BENCHMARK_TEMPLATE(SwapLoop, uint16_t)->Arg(4)->Arg(12);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
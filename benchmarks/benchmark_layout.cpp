@@ -0,0 +1,107 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Sums a 32 x 64 x 60 tile of a 32 x 64 x 64 tensor of uint32_t, mapping each index with
+// verified_layout, with checked_mul and checked_add for every element, and with the
+// unchecked arithmetic of a hand-written mapping.  Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_layout.cpp -lbenchmark -lpthread
+
+#include <cstdlib>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_layout.hpp"
+
+namespace {
+
+// Each benchmark hides the strides from the optimizer, as for a layout known only at run time,
+// so that the unchecked mapping is not vectorized for a unit stride.
+int32_t tile[] = { 32, 64, 60 };
+int32_t strides[] = { 64 * 64, 64, 1 };
+
+std::vector<uint32_t> const &tensor()
+{
+    static std::vector<uint32_t> values;
+    if (values.empty()) {
+        uint64_t state = 12345U;
+        values.resize(32 * 64 * 64);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values[i] = static_cast<uint32_t>(state >> 40);
+        }
+    }
+    return values;
+}
+
+void VerifiedLayout(benchmark::State &state)
+{
+    uint32_t const *const values = &tensor()[0];
+    benchmark::DoNotOptimize(strides);
+    for (auto _ : state) {
+        boost::verified_layout<int32_t, 3> const layout(tile, strides);
+        uint64_t sum = 0;
+        for (int32_t k = 0; k < tile[0]; ++k) {
+            for (int32_t j = 0; j < tile[1]; ++j) {
+                for (int32_t i = 0; i < tile[2]; ++i) {
+                    sum += values[layout(k, j, i)];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * tile[0] * tile[1] * tile[2]);
+}
+
+// Checks the offset of every element.
+void CheckedPerElement(benchmark::State &state)
+{
+    uint32_t const *const values = &tensor()[0];
+    benchmark::DoNotOptimize(strides);
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (int32_t k = 0; k < tile[0]; ++k) {
+            for (int32_t j = 0; j < tile[1]; ++j) {
+                for (int32_t i = 0; i < tile[2]; ++i) {
+                    boost::checked_result<int32_t> const plane = boost::checked_mul(k, strides[0]);
+                    boost::checked_result<int32_t> const row = boost::checked_mul(j, strides[1]);
+                    boost::checked_result<int32_t> const column = boost::checked_mul(i, strides[2]);
+                    boost::checked_result<int32_t> const partial = boost::checked_add(plane.value, row.value);
+                    boost::checked_result<int32_t> const offset = boost::checked_add(partial.value, column.value);
+                    if ((plane.result | row.result | column.result | partial.result | offset.result) != 0) {
+                        std::abort();
+                    }
+                    sum += values[offset.value];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * tile[0] * tile[1] * tile[2]);
+}
+
+void UncheckedMapping(benchmark::State &state)
+{
+    uint32_t const *const values = &tensor()[0];
+    benchmark::DoNotOptimize(strides);
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (int32_t k = 0; k < tile[0]; ++k) {
+            for (int32_t j = 0; j < tile[1]; ++j) {
+                for (int32_t i = 0; i < tile[2]; ++i) {
+                    sum += values[k * strides[0] + j * strides[1] + i * strides[2]];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * tile[0] * tile[1] * tile[2]);
+}
+
+BENCHMARK(VerifiedLayout);
+BENCHMARK(CheckedPerElement);
+BENCHMARK(UncheckedMapping);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Sums 256M int64_t elements with parallel_verified_sum on 1 to N threads, where N is the
+// number of hardware threads, next to a sequential verified_int accumulation.  Build with
+// Google Benchmark:
+//
+//     g++ -std=c++11 -O2 -I.. benchmark_parallel_sum.cpp -lbenchmark -lpthread
+
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_parallel.hpp"
+
+namespace {
+
+std::size_t const element_count = std::size_t(1) << 28;
+
+// Random values of both signs, small enough that the sum never overflows.
+std::vector<int64_t> const &elements()
+{
+    static std::vector<int64_t> values;
+    if (values.empty()) {
+        values.resize(element_count);
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < element_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values[i] = static_cast<int64_t>(state) >> 24;
+        }
+    }
+    return values;
+}
+
+void BM_sum_sequential(benchmark::State &state)
+{
+    std::vector<int64_t> const &values = elements();
+    for (auto _ : state) {
+        boost::verified_int64_t total(0);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            total += values[i];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+void BM_sum_parallel(benchmark::State &state)
+{
+    std::vector<int64_t> const &values = elements();
+    unsigned int const threads = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        boost::verified_int64_t const total =
+            boost::parallel_verified_sum<boost::throw_overflow>(&values[0], values.size(), threads);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+void thread_counts(benchmark::internal::Benchmark *benchmark)
+{
+    unsigned int const hardware_threads = std::thread::hardware_concurrency();
+    for (unsigned int threads = 1; threads < hardware_threads; threads *= 2) {
+        benchmark->Arg(threads);
+    }
+    benchmark->Arg(hardware_threads > 0 ? hardware_threads : 1);
+}
+
+BENCHMARK(BM_sum_sequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_sum_parallel)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+} // namespace anonymous
+
+BENCHMARK_MAIN();
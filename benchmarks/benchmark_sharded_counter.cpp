@@ -0,0 +1,53 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Increments one shared counter from 1 to N threads, where N is the number of hardware
+// threads, with sharded_verified_int, atomic_verified_int and std::atomic.  Build with
+// Google Benchmark:
+//
+//     g++ -std=c++11 -O2 -I.. benchmark_sharded_counter.cpp -lbenchmark -lpthread
+
+#include <atomic>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "verified_int_sharded.hpp"
+
+namespace {
+
+int const max_threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+void BM_increment_sharded(benchmark::State &state)
+{
+    static boost::sharded_verified_int<uint64_t, boost::throw_overflow> counter;
+    for (auto _ : state) {
+        ++counter;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_increment_atomic(benchmark::State &state)
+{
+    static boost::atomic_verified_int<uint64_t, boost::throw_overflow> counter;
+    for (auto _ : state) {
+        counter.fetch_add(1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_increment_builtin(benchmark::State &state)
+{
+    static std::atomic<uint64_t> counter(0);
+    for (auto _ : state) {
+        counter.fetch_add(1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_increment_sharded)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(BM_increment_atomic)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(BM_increment_builtin)->ThreadRange(1, max_threads)->UseRealTime();
+} // namespace anonymous
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Accumulates 10M elements with each overflow policy.  Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_sticky_overflow.cpp -lbenchmark -lpthread
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int.hpp"
+
+namespace {
+
+std::size_t const element_count = 10000000;
+
+typedef boost::with_detection<boost::throw_overflow, boost::overflow_detection_intrinsic> throw_intrinsic;
+typedef boost::with_detection<boost::sticky_overflow, boost::overflow_detection_intrinsic> sticky_intrinsic;
+
+// Random values of both signs, small enough that the sum never overflows.
+template <typename E>
+std::vector<E> const &elements()
+{
+    static std::vector<E> values;
+    if (values.empty()) {
+        values.resize(element_count);
+        uint32_t state = 12345U;
+        for (std::size_t i = 0; i < element_count; ++i) {
+            state = state * 1664525U + 1013904223U;
+            values[i] = static_cast<E>(static_cast<int32_t>(state) >> (40 - 8 * sizeof(E)));
+        }
+    }
+    return values;
+}
+
+template <typename A, typename E>
+void BM_accumulate_builtin(benchmark::State &state)
+{
+    std::vector<E> const &values = elements<E>();
+    for (auto _ : state) {
+        A total = 0;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            total += values[i];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <typename A, typename E, class Policy>
+void BM_accumulate_throw(benchmark::State &state)
+{
+    std::vector<E> const &values = elements<E>();
+    for (auto _ : state) {
+        boost::verified_int<A, Policy> total(0);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            total += values[i];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <typename A, typename E, class Policy>
+void BM_accumulate_sticky(benchmark::State &state)
+{
+    std::vector<E> const &values = elements<E>();
+    for (auto _ : state) {
+        boost::sticky_overflow::clear();
+        boost::verified_int<A, Policy> total(0);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            total += values[i];
+        }
+        bool const overflowed = boost::sticky_overflow::overflowed();
+        benchmark::DoNotOptimize(total);
+        benchmark::DoNotOptimize(overflowed);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK_TEMPLATE(BM_accumulate_builtin, int32_t, int16_t);
+BENCHMARK_TEMPLATE(BM_accumulate_throw, int32_t, int16_t, boost::throw_overflow);
+BENCHMARK_TEMPLATE(BM_accumulate_sticky, int32_t, int16_t, boost::sticky_overflow);
+
+BENCHMARK_TEMPLATE(BM_accumulate_builtin, int64_t, int32_t);
+BENCHMARK_TEMPLATE(BM_accumulate_throw, int64_t, int32_t, boost::throw_overflow);
+BENCHMARK_TEMPLATE(BM_accumulate_sticky, int64_t, int32_t, boost::sticky_overflow);
+BENCHMARK_TEMPLATE(BM_accumulate_throw, int64_t, int32_t, throw_intrinsic);
+BENCHMARK_TEMPLATE(BM_accumulate_sticky, int64_t, int32_t, sticky_intrinsic);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
@@ -0,0 +1,99 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Decodes a packed field of 1M varints into uint32_t: with decode_packed_varints into
+// verified_uint32_t, with decode_varint one at a time, and with a naive loop over the bytes
+// into uint32_t, which truncates without checking.  The varints are either all one byte,
+// or of one to five bytes.
+// Build with Google Benchmark:
+//
+//     g++ -O2 -I.. benchmark_varint.cpp -lbenchmark -lpthread
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "verified_int_varint.hpp"
+
+namespace {
+
+std::size_t const varint_count = 1000000;
+
+// The varints, of at most max_bytes bytes each.
+std::vector<uint8_t> const &varints(std::size_t const max_bytes)
+{
+    static std::vector<uint8_t> bytes[6];
+    std::vector<uint8_t> &packed = bytes[max_bytes];
+    if (packed.empty()) {
+        uint64_t state = 12345U;
+        for (std::size_t i = 0; i < varint_count; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::size_t const length = 1 + (state >> 60) % max_bytes;
+            std::size_t const bits = length < 5 ? 7 * length : 32;
+            uint32_t const value = static_cast<uint32_t>(state >> 32) >> (32 - bits);
+            boost::verified_uint32_t const verified(value);
+            uint8_t buffer[boost::max_varint_size];
+            packed.insert(packed.end(), buffer,
+                          boost::encode_varint(buffer, buffer + sizeof(buffer), verified).ptr);
+        }
+    }
+    return packed;
+}
+
+void PackedVarints(benchmark::State &state)
+{
+    std::vector<uint8_t> const &packed = varints(state.range(0));
+    std::vector<boost::verified_uint32_t> values(varint_count);
+    for (auto _ : state) {
+        boost::verified_packed_decode_result const decoded =
+            boost::decode_packed_varints(&packed[0], &packed[0] + packed.size(), &values[0], values.size());
+        benchmark::DoNotOptimize(decoded);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * varint_count);
+}
+
+void DecodeVarint(benchmark::State &state)
+{
+    std::vector<uint8_t> const &packed = varints(state.range(0));
+    std::vector<boost::verified_uint32_t> values(varint_count);
+    for (auto _ : state) {
+        uint8_t const *position = &packed[0];
+        uint8_t const *const last = position + packed.size();
+        for (std::size_t i = 0; position != last; ++i) {
+            position = boost::decode_varint(position, last, values[i]).ptr;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * varint_count);
+}
+
+void NaiveByteLoop(benchmark::State &state)
+{
+    std::vector<uint8_t> const &packed = varints(state.range(0));
+    std::vector<uint32_t> values(varint_count);
+    for (auto _ : state) {
+        uint8_t const *position = &packed[0];
+        uint8_t const *const last = position + packed.size();
+        for (std::size_t i = 0; position != last; ++i) {
+            uint64_t value = 0;
+            unsigned int shift = 0;
+            uint8_t byte;
+            do {
+                byte = *position++;
+                value |= uint64_t(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte >= 0x80 && position != last);
+            values[i] = static_cast<uint32_t>(value);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * varint_count);
+}
+
+BENCHMARK(PackedVarints)->Arg(1)->Arg(5);
+BENCHMARK(DecodeVarint)->Arg(1)->Arg(5);
+BENCHMARK(NaiveByteLoop)->Arg(1)->Arg(5);
+} // namespace anonymous
+
+BENCHMARK_MAIN();
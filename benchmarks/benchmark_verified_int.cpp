@@ -0,0 +1,346 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Measures every operator of verified_int, for every pair of operand types and every
+// overflow policy, against the same operation on built-in integers.  Build with Google
+// Benchmark and select benchmarks by name:
+//
+//     g++ -std=c++11 -O2 -I.. benchmark_verified_int.cpp -lbenchmark -lpthread -o benchmark_verified_int
+//     ./benchmark_verified_int --benchmark_filter='throughput/add/int32_t/.*'
+//     ./benchmark_verified_int --benchmark_out=verified_int.json --benchmark_out_format=json
+//
+// Benchmarks are named <mode>/<operation>/<left type>/<right type>/<policy>/<distribution>.
+//
+// throughput  Applies the operation to independent pairs of operands.
+// latency     Makes each operand depend on the previous result, so the operations form a
+//             dependency chain.
+//
+// random      Operand magnitudes are uniform in their number of bits.
+// near_limit  The left operand, or the assigned value, lies within 16 of a limit of the left
+//             type.
+//
+// Operands are chosen so that no operation overflows, which keeps the comparison between
+// policies fair and keeps throw_overflow from throwing.  The arithmetic operators use the
+// compound assignment form, which is what every binary verified_int operator applies.
+//----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <boost/integer_traits.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::overflow_detection_on;
+using boost::e_no_overflow_detected;
+
+std::size_t const operand_count = 4096;
+
+// Policy tag for the built-in integer baseline.
+struct builtin {};
+
+enum distribution { e_random, e_near_limit };
+enum mode { e_throughput, e_latency };
+
+template <typename T> char const *type_name();
+template <> char const *type_name<uint8_t>()  { return "uint8_t"; }
+template <> char const *type_name<uint16_t>() { return "uint16_t"; }
+template <> char const *type_name<uint32_t>() { return "uint32_t"; }
+template <> char const *type_name<uint64_t>() { return "uint64_t"; }
+template <> char const *type_name<int8_t>()   { return "int8_t"; }
+template <> char const *type_name<int16_t>()  { return "int16_t"; }
+template <> char const *type_name<int32_t>()  { return "int32_t"; }
+template <> char const *type_name<int64_t>()  { return "int64_t"; }
+
+template <typename L, typename R>
+struct detection
+{
+    typedef typename overflow_detection_on::template detection<L, R>::type type;
+};
+
+template <typename T>
+T random_value(std::mt19937_64 &generator)
+{
+    int const bits = static_cast<int>(generator() % (integer_traits<T>::digits + 1));
+    uint64_t const magnitude = bits == 0 ? 0 : generator() >> (64 - bits);
+    T value = static_cast<T>(magnitude);
+    if (boost::is_signed<T>::value && (generator() & 1)) {
+        value = static_cast<T>(-static_cast<int64_t>(magnitude));
+    }
+    return value;
+}
+
+// A value of T within 16 of a limit of U, or of T when that is not representable by T.
+template <typename T, typename U>
+T near_limit_value(std::mt19937_64 &generator)
+{
+    int const distance = static_cast<int>(generator() % 16);
+    bool const near_max = (generator() & 1) != 0;
+    U const value = near_max ? static_cast<U>(integer_traits<U>::const_max - distance)
+                             : static_cast<U>(integer_traits<U>::const_min + distance);
+    if (detection<T, U>::type::detect_overflow_assignment(value) == e_no_overflow_detected) {
+        return static_cast<T>(value);
+    }
+    return near_max ? static_cast<T>(integer_traits<T>::const_max - distance)
+                    : static_cast<T>(integer_traits<T>::const_min + distance);
+}
+
+// ***********************************************
+// Operations
+// ***********************************************
+struct assign_operation
+{
+    static bool const is_unary = false;
+    static char const *name() { return "assign"; }
+
+    template <typename L, typename R>
+    static void generate(std::mt19937_64 &generator, distribution const shape, L &left, R &right)
+    {
+        do {
+            left = 0;
+            right = shape == e_random ? random_value<R>(generator) : near_limit_value<R, L>(generator);
+        } while (detection<L, R>::type::detect_overflow_assignment(right) != e_no_overflow_detected);
+    }
+
+    template <typename L, typename R>
+    static L apply(L const left, R const right, builtin *)
+    {
+        (void)left;
+        return static_cast<L>(right);
+    }
+
+    template <typename L, typename R, class P>
+    static L apply(L const left, R const right, P *)
+    {
+        (void)left;
+        verified_int<L, P> value;
+        value = right;
+        return value;
+    }
+};
+
+#define GEN_BINARY_OPERATION(NAME, MATH_ASSIGN, DETECT_OVERFLOW, IS_DIVISION) \
+    struct NAME##_operation \
+    { \
+        static bool const is_unary = false; \
+        static char const *name() { return #NAME; } \
+        \
+        template <typename L, typename R> \
+        static void generate(std::mt19937_64 &generator, distribution const shape, L &left, R &right) \
+        { \
+            do { \
+                left = shape == e_random ? random_value<L>(generator) : near_limit_value<L, L>(generator); \
+                right = random_value<R>(generator); \
+            } while (!is_valid(left, right)); \
+        } \
+        \
+        template <typename L, typename R> \
+        static bool is_valid(L const left, R const right) \
+        { \
+            return detection<L, R>::type::DETECT_OVERFLOW(left, right) == e_no_overflow_detected && \
+                   (!IS_DIVISION || right != 0); \
+        } \
+        \
+        template <typename L, typename R> \
+        static L apply(L const left, R const right, builtin *) \
+        { \
+            L value = left; \
+            value MATH_ASSIGN right; \
+            return value; \
+        } \
+        \
+        template <typename L, typename R, class P> \
+        static L apply(L const left, R const right, P *) \
+        { \
+            verified_int<L, P> value(left); \
+            value MATH_ASSIGN right; \
+            return value; \
+        } \
+    };
+GEN_BINARY_OPERATION(add, +=, detect_overflow_addition, false)
+GEN_BINARY_OPERATION(subtract, -=, detect_overflow_subtraction, false)
+GEN_BINARY_OPERATION(multiply, *=, detect_overflow_multiplication, false)
+GEN_BINARY_OPERATION(divide, /=, detect_overflow_division, true)
+// verified_int does not verify %=, but a zero or min / -1 divisor still traps.
+GEN_BINARY_OPERATION(modulus, %=, detect_overflow_division, true)
+#undef GEN_BINARY_OPERATION
+
+#define GEN_UNARY_OPERATION(NAME, OPERATOR, DETECT_OVERFLOW) \
+    struct NAME##_operation \
+    { \
+        static bool const is_unary = true; \
+        static char const *name() { return #NAME; } \
+        \
+        template <typename L, typename R> \
+        static void generate(std::mt19937_64 &generator, distribution const shape, L &left, R &right) \
+        { \
+            right = 0; \
+            do { \
+                left = shape == e_random ? random_value<L>(generator) : near_limit_value<L, L>(generator); \
+            } while (detection<L, int>::type::DETECT_OVERFLOW(left, 1) != e_no_overflow_detected); \
+        } \
+        \
+        template <typename L, typename R> \
+        static L apply(L const left, R const right, builtin *) \
+        { \
+            (void)right; \
+            L value = left; \
+            OPERATOR value; \
+            return value; \
+        } \
+        \
+        template <typename L, typename R, class P> \
+        static L apply(L const left, R const right, P *) \
+        { \
+            (void)right; \
+            verified_int<L, P> value(left); \
+            OPERATOR value; \
+            return value; \
+        } \
+    };
+GEN_UNARY_OPERATION(increment, ++, detect_overflow_addition)
+GEN_UNARY_OPERATION(decrement, --, detect_overflow_subtraction)
+#undef GEN_UNARY_OPERATION
+
+// ***********************************************
+// Benchmarks
+// ***********************************************
+template <class Operation, typename L, typename R, class P>
+void run_benchmark(benchmark::State &state, distribution const shape, mode const timing)
+{
+    std::mt19937_64 generator(20111103U);
+    std::vector<L> left(operand_count);
+    std::vector<R> right(operand_count);
+    std::vector<L> result(operand_count);
+    for (std::size_t i = 0; i < operand_count; ++i) {
+        Operation::generate(generator, shape, left[i], right[i]);
+    }
+    L const *const lefts = &left[0];
+    R const *const rights = &right[0];
+    L *const results = &result[0];
+
+    if (timing == e_throughput) {
+        benchmark::DoNotOptimize(results);
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < operand_count; ++i) {
+                results[i] = Operation::apply(lefts[i], rights[i], static_cast<P *>(0));
+            }
+            benchmark::ClobberMemory();
+        }
+    } else {
+        // Always zero, but unknown to the compiler.
+        uint64_t zero = 0;
+        benchmark::DoNotOptimize(zero);
+        L previous = 0;
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < operand_count; ++i) {
+                uint64_t const dependency = static_cast<uint64_t>(previous) & zero;
+                previous = Operation::apply(static_cast<L>(lefts[i] ^ static_cast<L>(dependency)),
+                                            static_cast<R>(rights[i] ^ static_cast<R>(dependency)),
+                                            static_cast<P *>(0));
+            }
+        }
+        benchmark::DoNotOptimize(previous);
+    }
+    state.SetItemsProcessed(state.iterations() * operand_count);
+}
+
+template <class Operation, typename L, typename R, class P>
+void register_benchmark(char const *const policy_name)
+{
+    static char const *const mode_names[] = { "throughput", "latency" };
+    static char const *const distribution_names[] = { "random", "near_limit" };
+    for (int timing = e_throughput; timing <= e_latency; ++timing) {
+        for (int shape = e_random; shape <= e_near_limit; ++shape) {
+            std::string name = std::string(mode_names[timing]) + "/" + Operation::name() + "/" + type_name<L>();
+            if (!Operation::is_unary) {
+                name += std::string("/") + type_name<R>();
+            }
+            name += std::string("/") + policy_name + "/" + distribution_names[shape];
+            benchmark::RegisterBenchmark(name.c_str(), &run_benchmark<Operation, L, R, P>,
+                                         static_cast<distribution>(shape), static_cast<mode>(timing));
+        }
+    }
+}
+
+template <class Operation, typename L, typename R>
+void register_policies()
+{
+    register_benchmark<Operation, L, R, builtin>("builtin");
+    register_benchmark<Operation, L, R, boost::ignore_overflow>("ignore_overflow");
+    register_benchmark<Operation, L, R, boost::throw_overflow>("throw_overflow");
+    register_benchmark<Operation, L, R, boost::saturate_overflow>("saturate_overflow");
+    register_benchmark<Operation, L, R, boost::assert_overflow>("assert_overflow");
+}
+
+template <class Operation, typename L>
+void register_right_types()
+{
+    register_policies<Operation, L, uint8_t>();
+    register_policies<Operation, L, uint16_t>();
+    register_policies<Operation, L, uint32_t>();
+    register_policies<Operation, L, uint64_t>();
+    register_policies<Operation, L, int8_t>();
+    register_policies<Operation, L, int16_t>();
+    register_policies<Operation, L, int32_t>();
+    register_policies<Operation, L, int64_t>();
+}
+
+template <class Operation, typename L>
+void register_operation_for_left(boost::true_type is_unary)
+{
+    (void)is_unary;
+    register_policies<Operation, L, L>();
+}
+
+template <class Operation, typename L>
+void register_operation_for_left(boost::false_type is_unary)
+{
+    (void)is_unary;
+    register_right_types<Operation, L>();
+}
+
+template <class Operation>
+void register_operation()
+{
+    typedef boost::integral_constant<bool, Operation::is_unary> is_unary;
+    register_operation_for_left<Operation, uint8_t>(is_unary());
+    register_operation_for_left<Operation, uint16_t>(is_unary());
+    register_operation_for_left<Operation, uint32_t>(is_unary());
+    register_operation_for_left<Operation, uint64_t>(is_unary());
+    register_operation_for_left<Operation, int8_t>(is_unary());
+    register_operation_for_left<Operation, int16_t>(is_unary());
+    register_operation_for_left<Operation, int32_t>(is_unary());
+    register_operation_for_left<Operation, int64_t>(is_unary());
+}
+} // namespace anonymous
+
+int main(int argc, char **argv)
+{
+    register_operation<assign_operation>();
+    register_operation<add_operation>();
+    register_operation<subtract_operation>();
+    register_operation<multiply_operation>();
+    register_operation<divide_operation>();
+    register_operation<modulus_operation>();
+    register_operation<increment_operation>();
+    register_operation<decrement_operation>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,148 @@
+#!/bin/sh
+#               Copyright Ben Robinson 2011.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE_1_0.txt or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+#
+# Compiles codegen_kernels.cpp at -O2 and -O3, and fails when a kernel using
+# verified_int<T, ignore_overflow> disassembles differently from the same kernel using T.
+# Also reports the instruction count of every kernel for each overflow policy.
+#
+#     CXX=clang++ CXXFLAGS="-march=native" ./check_codegen.sh
+#
+# Requires objdump.  Padding nops are ignored, jump targets are compared relative to the
+# start of their function, and calls keep the callee name.  Streams which only differ by
+# register allocation, that is which one consistent one-to-one renaming of the registers maps
+# onto each other, are reported as a warning rather than a failure.
+
+CXX=${CXX:-c++}
+OBJDUMP=${OBJDUMP:-objdump}
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/verified_int_codegen.XXXXXX") || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+KERNELS="add multiply_mixed subtract_narrow divide assign_narrowing accumulate dot_product axpy count_up"
+FLAVORS="builtin ignore throw saturate assert"
+STATUS=0
+
+# Prints the normalized instructions of one function.
+function_body() {
+    awk -v name="$2" '
+        $0 ~ "^[0-9a-f]+ <" name ">:$" { found = 1; next }
+        found && /^$/ { exit }
+        found {
+            sub(/^ *[0-9a-f]+:[ \t]*/, "")
+            if ($0 ~ /^(nop|data16|xchg +%ax,%ax|cs nopw)/) next
+            gsub("[0-9a-f]+ <" name "[+>]", "<")
+            gsub(/[0-9a-f]+ </, "<")
+            print
+        }' "$1"
+}
+
+# Succeeds when one consistent one-to-one renaming of the general purpose and vector
+# registers maps the first stream onto the second.  A register is renamed with all of its
+# widths, so %eax to %edx also renames %rax to %rdx, and each operand keeps its width.
+# %rsp, %rip and every other register keep their names.
+renames_registers() {
+    awk '
+        # Sets family and width for a renamable register, without its %.
+        function classify(register) {
+            if (register ~ /^[xyz]mm[0-9]+$/) {
+                family = "v" substr(register, 4); width = substr(register, 1, 3); return 1
+            }
+            if (register ~ /^r([89]|1[0-5])[dwb]?$/) {
+                family = register; width = "q"
+                if (sub(/d$/, "", family)) width = "d"
+                else if (sub(/w$/, "", family)) width = "w"
+                else if (sub(/b$/, "", family)) width = "b"
+                return 1
+            }
+            if (register ~ /^[re]?(ax|bx|cx|dx|si|di|bp)$/) {
+                family = register; width = "w"
+                if (sub(/^r/, "", family)) width = "q"
+                else if (sub(/^e/, "", family)) width = "d"
+                return 1
+            }
+            if (register ~ /^([abcd]l|sil|dil|bpl)$/) {
+                family = length(register) == 2 ? substr(register, 1, 1) "x" : substr(register, 1, 2)
+                width = "b"; return 1
+            }
+            if (register ~ /^[abcd]h$/) {
+                family = substr(register, 1, 1) "x"; width = "h"; return 1
+            }
+            return 0
+        }
+        # Returns the line with each renamable register replaced by its width, and lists the
+        # register families in order in families[1..count].
+        function shape(line,    result, token) {
+            result = ""; count = 0
+            while (match(line, /%[a-z0-9]+/)) {
+                token = substr(line, RSTART + 1, RLENGTH - 1)
+                result = result substr(line, 1, RSTART - 1)
+                if (classify(token)) {
+                    result = result "%" width; families[++count] = family
+                } else {
+                    result = result "%" token
+                }
+                line = substr(line, RSTART + RLENGTH)
+            }
+            return result line
+        }
+        FILENAME == ARGV[1] { first[++lines] = $0; next }
+        {
+            if (++seen > lines) exit 1
+            expected = shape(first[seen]); n = count
+            for (i = 1; i <= n; ++i) from[i] = families[i]
+            if (shape($0) != expected || count != n) exit 1
+            for (i = 1; i <= n; ++i) {
+                if ((from[i] in forward && forward[from[i]] != families[i]) ||
+                    (families[i] in backward && backward[families[i]] != from[i])) exit 1
+                forward[from[i]] = families[i]; backward[families[i]] = from[i]
+            }
+        }
+        END { if (seen != lines) exit 1 }' "$1" "$2"
+}
+
+for LEVEL in -O2 -O3; do
+    OBJECT="$WORK/kernels$LEVEL.o"
+    LISTING="$WORK/kernels$LEVEL.s"
+    # Identical code folding would turn one flavor into a jump to the other.
+    if ! $CXX $LEVEL -fno-ipa-icf $CXXFLAGS -I"$ROOT" -c "$HERE/codegen_kernels.cpp" -o "$OBJECT" 2>/dev/null &&
+       ! $CXX $LEVEL $CXXFLAGS -I"$ROOT" -c "$HERE/codegen_kernels.cpp" -o "$OBJECT"; then
+        echo "FAILED to compile codegen_kernels.cpp at $LEVEL"
+        exit 1
+    fi
+    $OBJDUMP -d --no-show-raw-insn "$OBJECT" > "$LISTING" || exit 1
+
+    echo "Instruction counts at $LEVEL"
+    printf '%-18s' "kernel"
+    for FLAVOR in $FLAVORS; do
+        printf '%10s' "$FLAVOR"
+    done
+    echo
+
+    for KERNEL in $KERNELS; do
+        printf '%-18s' "$KERNEL"
+        for FLAVOR in $FLAVORS; do
+            function_body "$LISTING" "${FLAVOR}_$KERNEL" > "$WORK/$FLAVOR.txt"
+            printf '%10s' "$(wc -l < "$WORK/$FLAVOR.txt" | tr -d ' ')"
+        done
+        echo
+        if ! diff "$WORK/builtin.txt" "$WORK/ignore.txt" > "$WORK/diff.txt"; then
+            if renames_registers "$WORK/builtin.txt" "$WORK/ignore.txt"; then
+                echo "WARNING: ignore_$KERNEL only differs from builtin_$KERNEL by register allocation at $LEVEL"
+            else
+                echo "FAILED: ignore_$KERNEL differs from builtin_$KERNEL at $LEVEL"
+                cat "$WORK/diff.txt"
+                STATUS=1
+            fi
+        fi
+    done
+    echo
+done
+
+if [ $STATUS -eq 0 ]; then
+    echo "PASSED: ignore_overflow matches the built-in for every kernel"
+fi
+exit $STATUS
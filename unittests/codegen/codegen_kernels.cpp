@@ -0,0 +1,175 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Representative kernels, each emitted once per integer flavor as an extern "C" function
+// named <flavor>_<kernel>.  check_codegen.sh compares the disassembly of the builtin and
+// ignore flavors, which must be identical, and reports the size of the checked flavors.
+//----------------------------------------------------------------------------
+
+#include <cstddef>
+#include "verified_int.hpp"
+
+namespace {
+
+template <typename T>
+struct builtin_int
+{
+    typedef T type;
+};
+
+template <typename T>
+struct ignore_int
+{
+    typedef boost::verified_int<T, boost::ignore_overflow> type;
+};
+
+template <typename T>
+struct throw_int
+{
+    typedef boost::verified_int<T, boost::throw_overflow> type;
+};
+
+template <typename T>
+struct saturate_int
+{
+    typedef boost::verified_int<T, boost::saturate_overflow> type;
+};
+
+template <typename T>
+struct assert_int
+{
+    typedef boost::verified_int<T, boost::assert_overflow> type;
+};
+
+template <template <typename> class Flavor>
+struct kernels
+{
+    typedef typename Flavor<int32_t>::type int32;
+    typedef typename Flavor<uint32_t>::type uint32;
+    typedef typename Flavor<int64_t>::type int64;
+    typedef typename Flavor<uint8_t>::type uint8;
+
+    static int32_t add(int32_t const left, int32_t const right)
+    {
+        int32 value(left);
+        value += right;
+        return value;
+    }
+
+    static int64_t multiply_mixed(int64_t const left, int16_t const right)
+    {
+        int64 value(left);
+        value *= right;
+        return value;
+    }
+
+    static uint8_t subtract_narrow(uint8_t const left, int16_t const right)
+    {
+        uint8 value(left);
+        value -= right;
+        return value;
+    }
+
+    static int32_t divide(int32_t const left, int32_t const right)
+    {
+        int32 value(left);
+        value /= right;
+        return value;
+    }
+
+    static uint32_t assign_narrowing(int64_t const right)
+    {
+        uint32 value;
+        value = right;
+        return value;
+    }
+
+    static int64_t accumulate(int32_t const *const values, std::size_t const count)
+    {
+        int64 total(0);
+        for (std::size_t i = 0; i < count; ++i) {
+            total += values[i];
+        }
+        return total;
+    }
+
+    static int32_t dot_product(int32_t const *const left, int32_t const *const right, std::size_t const count)
+    {
+        int32 total(0);
+        for (std::size_t i = 0; i < count; ++i) {
+            int32 const product = int32(left[i]) * right[i];
+            total += product;
+        }
+        return total;
+    }
+
+    static void axpy(int32_t const a, int32_t const *const x, int32_t *const y, std::size_t const count)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            int32 value(x[i]);
+            value *= a;
+            value += y[i];
+            y[i] = value;
+        }
+    }
+
+    static uint32_t count_up(uint32_t const count)
+    {
+        uint32 value(0U);
+        for (uint32_t i = 0; i < count; ++i) {
+            ++value;
+        }
+        return value;
+    }
+};
+} // namespace anonymous
+
+#define GEN_FLAVOR_KERNELS(FLAVOR) \
+    extern "C" int32_t FLAVOR##_add(int32_t const left, int32_t const right) \
+    { \
+        return kernels<FLAVOR##_int>::add(left, right); \
+    } \
+    extern "C" int64_t FLAVOR##_multiply_mixed(int64_t const left, int16_t const right) \
+    { \
+        return kernels<FLAVOR##_int>::multiply_mixed(left, right); \
+    } \
+    extern "C" uint8_t FLAVOR##_subtract_narrow(uint8_t const left, int16_t const right) \
+    { \
+        return kernels<FLAVOR##_int>::subtract_narrow(left, right); \
+    } \
+    extern "C" int32_t FLAVOR##_divide(int32_t const left, int32_t const right) \
+    { \
+        return kernels<FLAVOR##_int>::divide(left, right); \
+    } \
+    extern "C" uint32_t FLAVOR##_assign_narrowing(int64_t const right) \
+    { \
+        return kernels<FLAVOR##_int>::assign_narrowing(right); \
+    } \
+    extern "C" int64_t FLAVOR##_accumulate(int32_t const *const values, std::size_t const count) \
+    { \
+        return kernels<FLAVOR##_int>::accumulate(values, count); \
+    } \
+    extern "C" int32_t FLAVOR##_dot_product(int32_t const *const left, int32_t const *const right, \
+                                            std::size_t const count) \
+    { \
+        return kernels<FLAVOR##_int>::dot_product(left, right, count); \
+    } \
+    extern "C" void FLAVOR##_axpy(int32_t const a, int32_t const *const x, int32_t *const y, \
+                                  std::size_t const count) \
+    { \
+        kernels<FLAVOR##_int>::axpy(a, x, y, count); \
+    } \
+    extern "C" uint32_t FLAVOR##_count_up(uint32_t const count) \
+    { \
+        return kernels<FLAVOR##_int>::count_up(count); \
+    }
+
+GEN_FLAVOR_KERNELS(builtin)
+GEN_FLAVOR_KERNELS(ignore)
+GEN_FLAVOR_KERNELS(throw)
+GEN_FLAVOR_KERNELS(saturate)
+GEN_FLAVOR_KERNELS(assert)
+#undef GEN_FLAVOR_KERNELS
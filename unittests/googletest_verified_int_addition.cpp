@@ -9,6 +9,7 @@
 #include <testsystem.hpp>
 #include <stringutils.hpp>
 #include <climits>
+#include <boost/integer_traits.hpp>
 #include "verified_int.hpp"
 
 namespace {
@@ -655,4 +656,119 @@ TEST(verified_intDivision_TDD, UnSignedMinAddOne) {
         lhs += rhs;
     }));
 }
+
+template <typename L, typename R>
+void expect_exact_addition() {
+    typedef boost::do_detect_overflow<L, R> detection_type;
+    for (int32_t left = boost::integer_traits<L>::const_min; left <= boost::integer_traits<L>::const_max; ++left) {
+        for (int32_t right = boost::integer_traits<R>::const_min; right <= boost::integer_traits<R>::const_max; ++right) {
+            int32_t const exact = left + right;
+            boost::overflow_result expected = boost::e_no_overflow_detected;
+            if (exact > boost::integer_traits<L>::const_max) {
+                expected = boost::e_positive_overflow_detected;
+            } else if (exact < boost::integer_traits<L>::const_min) {
+                expected = boost::e_negative_overflow_detected;
+            }
+            ASSERT_EQ(expected, detection_type::detect_overflow_addition(
+                static_cast<L>(left), static_cast<R>(right))) << left << " + " << right;
+        }
+    }
+}
+
+TEST(verified_intAddition_TDD, ExactDetection8Bit) {
+    expect_exact_addition<uint8_t, uint8_t>();
+    expect_exact_addition<uint8_t, int8_t>();
+    expect_exact_addition<int8_t, uint8_t>();
+    expect_exact_addition<int8_t, int8_t>();
+}
+
+TEST(verified_intAddition_TDD, ExactDetection16Bit) {
+    expect_exact_addition<uint16_t, int8_t>();
+    expect_exact_addition<int16_t, uint8_t>();
+    expect_exact_addition<uint8_t, int16_t>();
+    expect_exact_addition<int8_t, uint16_t>();
+}
+
+// 32-bit operands are too wide to check exhaustively, so each operand takes the values
+// near its limits and near zero.
+template <typename L, typename R>
+void expect_exact_addition_near_limits() {
+    typedef boost::do_detect_overflow<L, R> detection_type;
+    int64_t const left_min = boost::integer_traits<L>::const_min;
+    int64_t const left_max = boost::integer_traits<L>::const_max;
+    int64_t const right_min = boost::integer_traits<R>::const_min;
+    int64_t const right_max = boost::integer_traits<R>::const_max;
+    int64_t const lefts[] = { left_min, left_min + 1, left_min + 2, -5, -3, -1, 0, 1, 3, 5,
+                              left_max - 2, left_max - 1, left_max };
+    int64_t const rights[] = { right_min, right_min + 1, right_min + 2, -5, -3, -1, 0, 1, 3, 5,
+                               right_max - 2, right_max - 1, right_max };
+    for (std::size_t i = 0; i < sizeof(lefts) / sizeof(lefts[0]); ++i) {
+        for (std::size_t j = 0; j < sizeof(rights) / sizeof(rights[0]); ++j) {
+            int64_t const left = lefts[i];
+            int64_t const right = rights[j];
+            if (left < left_min || left > left_max || right < right_min || right > right_max) {
+                continue;
+            }
+            int64_t const exact = left + right;
+            boost::overflow_result expected = boost::e_no_overflow_detected;
+            if (exact > left_max) {
+                expected = boost::e_positive_overflow_detected;
+            } else if (exact < left_min) {
+                expected = boost::e_negative_overflow_detected;
+            }
+            ASSERT_EQ(expected, detection_type::detect_overflow_addition(
+                static_cast<L>(left), static_cast<R>(right))) << left << " + " << right;
+        }
+    }
+}
+
+TEST(verified_intAddition_TDD, ExactDetection32Bit) {
+    expect_exact_addition_near_limits<int32_t, int32_t>();
+    expect_exact_addition_near_limits<int32_t, uint32_t>();
+
+    verified_int<int32_t, throw_overflow> value(5);
+    EXPECT_NO_THROW(value += int32_t(-3));
+    EXPECT_NO_THROW(value += int32_t(3));
+    EXPECT_EQ(5, value);
+}
+
+// A positive left and a negative right never overflow, including for 64-bit operands,
+// which are not widened, and for an unsigned left with a wider signed right.  A negative left
+// with a wider unsigned right is checked without wrapping too.
+TEST(verified_intAddition_TDD, MixedSignsDoNotOverflow) {
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<int64_t, int64_t>::detect_overflow_addition(4401, -19)));
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<int64_t, int64_t>::detect_overflow_addition(
+                  boost::integer_traits<int64_t>::const_max, boost::integer_traits<int64_t>::const_min)));
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<int32_t, int64_t>::detect_overflow_addition(5, int64_t(-5))));
+    EXPECT_EQ(boost::e_negative_overflow_detected,
+              (boost::do_detect_overflow<int64_t, int64_t>::detect_overflow_addition(
+                  -1, boost::integer_traits<int64_t>::const_min)));
+    EXPECT_EQ(boost::e_negative_overflow_detected,
+              (boost::do_detect_overflow<int32_t, int64_t>::detect_overflow_addition(
+                  -1, int64_t(boost::integer_traits<int32_t>::const_min))));
+
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<uint32_t, int64_t>::detect_overflow_addition(5U, int64_t(-3))));
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<uint32_t, int64_t>::detect_overflow_addition(
+                  boost::integer_traits<uint32_t>::const_max,
+                  -int64_t(boost::integer_traits<uint32_t>::const_max))));
+    EXPECT_EQ(boost::e_negative_overflow_detected,
+              (boost::do_detect_overflow<uint32_t, int64_t>::detect_overflow_addition(3U, int64_t(-5))));
+    // A negative left with a 64-bit unsigned right.
+    EXPECT_EQ(boost::e_no_overflow_detected,
+              (boost::do_detect_overflow<int32_t, uint64_t>::detect_overflow_addition(
+                  -7, uint64_t(boost::integer_traits<int32_t>::const_max) + 7U)));
+    EXPECT_EQ(boost::e_positive_overflow_detected,
+              (boost::do_detect_overflow<int32_t, uint64_t>::detect_overflow_addition(
+                  -7, uint64_t(boost::integer_traits<int32_t>::const_max) + 8U)));
+
+    verified_int<uint32_t, throw_overflow> sum(5U);
+    EXPECT_NO_THROW(sum += int64_t(-3));
+    EXPECT_EQ(2U, sum);
+    EXPECT_THROW(sum += int64_t(-3), boost::negative_overflow_detected);
+}
 } // namespace anonymous
@@ -0,0 +1,93 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int_arena.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_arena;
+using boost::verified_size_t;
+
+struct header
+{
+    uint32_t count;
+    uint8_t kind;
+};
+
+TEST(verified_intArena_TDD, BumpsAligned) {
+    uint64_t buffer[16];
+    verified_arena arena(buffer, sizeof(buffer));
+    EXPECT_EQ(128U, arena.capacity());
+
+    uint8_t *const bytes = arena.allocate<uint8_t>(3);
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(buffer), bytes);
+    uint32_t *const words = arena.allocate<uint32_t>(2);
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(buffer) + 4, reinterpret_cast<uint8_t *>(words));
+    void *const line = arena.allocate(8, 16);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(line) % 16);
+    EXPECT_EQ(static_cast<std::size_t>(reinterpret_cast<uint8_t *>(line) + 8 - reinterpret_cast<uint8_t *>(buffer)),
+              arena.used());
+
+    arena.reset();
+    EXPECT_EQ(0U, arena.used());
+    EXPECT_EQ(reinterpret_cast<uint64_t *>(buffer), arena.allocate<uint64_t>(16));
+    EXPECT_EQ(128U, arena.used());
+    EXPECT_TRUE(arena.allocate<uint8_t>(0) != 0);
+
+    // The sizes are verified.
+    EXPECT_THROW(arena.capacity() - arena.used() - 1U, boost::negative_overflow_detected);
+    verified_size_t const size(uint64_t(2));
+    EXPECT_THROW(size * integer_traits<std::size_t>::const_max, boost::positive_overflow_detected);
+}
+
+TEST(verified_intArena_TDD, FailsInsteadOfWrapping) {
+    uint64_t buffer[16];
+    verified_arena arena(buffer, sizeof(buffer));
+    arena.allocate<uint8_t>(1);
+
+    // Too large for the rest of the buffer.
+    EXPECT_TRUE(arena.allocate<uint64_t>(16) == 0);
+    EXPECT_EQ(1U, arena.used());
+    EXPECT_TRUE(arena.allocate<uint64_t>(15) != 0);
+    EXPECT_EQ(128U, arena.used());
+    EXPECT_TRUE(arena.allocate<uint8_t>(1) == 0);
+
+    // count * sizeof(T) wraps around to a small size.
+    arena.reset();
+    std::size_t const wrapping = integer_traits<std::size_t>::const_max / 8 + 2;
+    EXPECT_EQ(8U, wrapping * 8);
+    EXPECT_TRUE(arena.allocate<uint64_t>(wrapping) == 0);
+    EXPECT_TRUE((arena.allocate_trailing<header, uint64_t>(wrapping)) == 0);
+    EXPECT_TRUE((arena.allocate_trailing<header, uint64_t>(integer_traits<std::size_t>::const_max / 8)) == 0);
+
+    // The end of the allocation wraps around, or the pointer rounded up is past the end.
+    EXPECT_TRUE(arena.allocate(integer_traits<std::size_t>::const_max, 1) == 0);
+    EXPECT_TRUE(arena.allocate(1, std::size_t(1) << (8 * sizeof(std::size_t) - 1)) == 0);
+    EXPECT_EQ(0U, arena.used());
+}
+
+TEST(verified_intArena_TDD, AllocatesTrailing) {
+    EXPECT_EQ(8U, (verified_arena::trailing<header, uint32_t>()));
+    EXPECT_EQ(8U, (verified_arena::trailing<header, uint8_t>()));
+    EXPECT_EQ(4U, (verified_arena::trailing<uint32_t, uint8_t>()));
+    EXPECT_EQ(8U, (verified_arena::trailing<uint8_t, uint64_t>()));
+
+    uint64_t buffer[16];
+    verified_arena arena(buffer, sizeof(buffer));
+    arena.allocate<uint8_t>(1);
+    header *const first = arena.allocate_trailing<header, uint16_t>(3);
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(buffer) + 4, reinterpret_cast<uint8_t *>(first));
+    EXPECT_EQ(4U + 8U + 6U, arena.used());
+    EXPECT_TRUE((arena.allocate_trailing<header, uint16_t>(51)) == 0);
+    EXPECT_TRUE((arena.allocate_trailing<header, uint16_t>(50)) != 0);
+    EXPECT_EQ(128U, arena.used());
+}
+} // namespace anonymous
@@ -0,0 +1,158 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_atomic.hpp"
+#include "verified_int_counting.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::atomic_verified_int;
+using boost::counting_overflow;
+using boost::overflow_counters;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::sticky_overflow;
+using boost::wraps_on_overflow;
+using boost::e_addition_operation;
+using boost::e_positive_overflow_detected;
+
+// Applies each operand to an atomic_verified_int and to a verified_int, which must agree.
+template <typename T, class P>
+void expect_operations_match(T const start, int64_t const *const operands, std::size_t const count)
+{
+    atomic_verified_int<T, P> shared((verified_int<T, P>(start)));
+    verified_int<T, P> expected(start);
+    for (std::size_t index = 0; index < count; ++index) {
+        int64_t const operand = operands[index];
+        T const previous = static_cast<T>(expected);
+        T returned;
+        switch (index % 3) {
+        case 0: returned = shared.fetch_add(operand); expected += operand; break;
+        case 1: returned = shared.fetch_sub(operand); expected -= operand; break;
+        default: returned = shared.fetch_mul(operand); expected *= operand; break;
+        }
+        EXPECT_EQ(previous, returned) << index;
+        EXPECT_EQ(T(expected), T(shared.load())) << index;
+    }
+}
+
+template <typename T>
+void expect_policies_match()
+{
+    // The maximum of T, or of int64_t for uint64_t.
+    int64_t const largest = static_cast<int64_t>((std::min)(static_cast<uint64_t>(integer_traits<T>::const_max),
+                                                            static_cast<uint64_t>(integer_traits<int64_t>::const_max)));
+    int64_t const operands[] = { 100, 1000, 3, -7, 100000, 2, largest, 1, -1, 5, 0, 9 };
+    std::size_t const count = sizeof(operands) / sizeof(operands[0]);
+    expect_operations_match<T, saturate_overflow>(T(1), operands, count);
+    expect_operations_match<T, ignore_overflow>(T(1), operands, count);
+    expect_operations_match<T, saturate_overflow>(integer_traits<T>::const_max, operands, count);
+    expect_operations_match<T, ignore_overflow>(integer_traits<T>::const_min, operands, count);
+}
+
+TEST(verified_intAtomic_TDD, MatchesVerifiedInt) {
+    expect_policies_match<uint8_t>();
+    expect_policies_match<uint16_t>();
+    expect_policies_match<uint32_t>();
+    expect_policies_match<uint64_t>();
+    expect_policies_match<int8_t>();
+    expect_policies_match<int16_t>();
+    expect_policies_match<int32_t>();
+    expect_policies_match<int64_t>();
+}
+
+TEST(verified_intAtomic_TDD, WrappingPolicies) {
+    EXPECT_TRUE(wraps_on_overflow<ignore_overflow>::value);
+    EXPECT_TRUE(wraps_on_overflow<sticky_overflow>::value);
+    EXPECT_TRUE(wraps_on_overflow<counting_overflow<> >::value);
+    EXPECT_FALSE(wraps_on_overflow<saturate_overflow>::value);
+    EXPECT_FALSE(wraps_on_overflow<throw_overflow>::value);
+    EXPECT_FALSE(wraps_on_overflow<counting_overflow<saturate_overflow> >::value);
+}
+
+TEST(verified_intAtomic_TDD, ThrowLeavesValueUnchanged) {
+    atomic_verified_int<int16_t, throw_overflow> shared((verified_int<int16_t, throw_overflow>(32000)));
+    EXPECT_THROW(shared.fetch_add(1000), boost::positive_overflow_detected);
+    EXPECT_EQ(32000, shared.load());
+    EXPECT_THROW(shared.fetch_mul(-2), boost::negative_overflow_detected);
+    EXPECT_EQ(32000, shared.load());
+    EXPECT_EQ(32000, shared.fetch_add(767));
+    EXPECT_EQ(32767, shared.load());
+    EXPECT_THROW(shared.store(40000), boost::positive_overflow_detected);
+    EXPECT_EQ(32767, shared.load());
+}
+
+TEST(verified_intAtomic_TDD, StickyAndCountingRecordOnce) {
+    sticky_overflow::clear();
+    atomic_verified_int<uint8_t, sticky_overflow> sticky;
+    sticky.store(250U);
+    EXPECT_EQ(250U, sticky.fetch_add(5U));
+    EXPECT_FALSE(sticky_overflow::overflowed());
+    EXPECT_EQ(255U, sticky.fetch_add(2U));
+    EXPECT_TRUE(sticky_overflow::overflowed());
+    EXPECT_EQ(1U, sticky.load());
+    sticky_overflow::clear();
+
+    overflow_counters::reset();
+    atomic_verified_int<uint8_t, counting_overflow<> > counted;
+    counted.store(200U);
+    counted.fetch_add(100U);
+    counted.fetch_add(100U);
+    EXPECT_EQ(144U, counted.load());
+    EXPECT_EQ(1U, (overflow_counters::count<uint8_t, uint32_t>(e_addition_operation, e_positive_overflow_detected)));
+    overflow_counters::reset();
+}
+
+// Threads which increment concurrently lose no increments, and saturate exactly once the
+// total passes the maximum.
+TEST(verified_intAtomic_TDD, ConcurrentIncrements) {
+    unsigned int const thread_count = 4;
+    unsigned int const increments = 20000;
+    atomic_verified_int<uint32_t, saturate_overflow> total;
+    atomic_verified_int<uint16_t, saturate_overflow> saturated;
+    atomic_verified_int<int32_t, ignore_overflow> wrapped;
+    atomic_verified_int<int32_t, throw_overflow> bounded((verified_int<int32_t, throw_overflow>(
+        integer_traits<int32_t>::const_max - int32_t(increments))));
+    std::vector<unsigned int> throws(thread_count, 0U);
+    std::vector<std::thread> threads;
+    for (unsigned int thread = 0; thread < thread_count; ++thread) {
+        threads.push_back(std::thread([&, thread]() {
+            for (unsigned int index = 0; index < increments; ++index) {
+                total.fetch_add(1U);
+                saturated.fetch_add(1U);
+                wrapped.fetch_sub(1);
+                try {
+                    bounded.fetch_add(1);
+                } catch (boost::positive_overflow_detected const &) {
+                    ++throws[thread];
+                }
+            }
+        }));
+    }
+    for (unsigned int thread = 0; thread < thread_count; ++thread) {
+        threads[thread].join();
+    }
+    EXPECT_EQ(thread_count * increments, total.load());
+    EXPECT_EQ(integer_traits<uint16_t>::const_max, saturated.load());
+    EXPECT_EQ(-int32_t(thread_count * increments), wrapped.load());
+    EXPECT_EQ(integer_traits<int32_t>::const_max, bounded.load());
+    unsigned int all_throws = 0;
+    for (unsigned int thread = 0; thread < thread_count; ++thread) {
+        all_throws += throws[thread];
+    }
+    EXPECT_EQ((thread_count - 1) * increments, all_throws);
+}
+} // namespace anonymous
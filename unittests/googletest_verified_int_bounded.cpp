@@ -0,0 +1,124 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include "verified_int_bounded.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::is_same;
+using boost::bounded_int;
+using boost::verified_int;
+using boost::saturate_overflow;
+using boost::verified_uint8_t;
+using boost::verified_int32_t;
+
+// Ranges select the smallest storage type.
+BOOST_STATIC_ASSERT((is_same<bounded_int<0, 255>::value_type, uint8_t>::value));
+BOOST_STATIC_ASSERT((is_same<bounded_int<0, 256>::value_type, uint16_t>::value));
+BOOST_STATIC_ASSERT((is_same<bounded_int<-1, 127>::value_type, int8_t>::value));
+BOOST_STATIC_ASSERT((is_same<bounded_int<-129, 0>::value_type, int16_t>::value));
+BOOST_STATIC_ASSERT((is_same<bounded_int<0, 4294967296LL>::value_type, uint64_t>::value));
+BOOST_STATIC_ASSERT(sizeof(bounded_int<0, 3>) == 1);
+
+TEST(verified_intBounded_TDD, Construction) {
+    bounded_int<0, 3> const offset(3);
+    EXPECT_EQ(3U, offset.value());
+    EXPECT_EQ(0U, (bounded_int<0, 3>().value()));
+    EXPECT_EQ(5, (bounded_int<5, 9>().value()));
+    EXPECT_EQ(-2, (bounded_int<-9, -2>().value()));
+
+    EXPECT_THROW(({ bounded_int<0, 3> out_of_range(4); }), boost::positive_overflow_detected);
+    EXPECT_THROW(({ bounded_int<0, 3> out_of_range(-1); }), boost::negative_overflow_detected);
+    EXPECT_THROW(({ bounded_int<5, 9> out_of_range(uint8_t(4U)); }), boost::negative_overflow_detected);
+    EXPECT_THROW(({ bounded_int<-9, -2> out_of_range(0); }), boost::positive_overflow_detected);
+    EXPECT_THROW(({ bounded_int<-9, -2> out_of_range(-1); }), boost::positive_overflow_detected);
+    EXPECT_THROW(({ bounded_int<-9, -2> out_of_range(int8_t(-10)); }), boost::negative_overflow_detected);
+    EXPECT_EQ(-2, (bounded_int<-9, -2>(int64_t(-2)).value()));
+    EXPECT_THROW(({ bounded_int<0, 3> out_of_range(integer_traits<uint64_t>::const_max); }),
+                 boost::positive_overflow_detected);
+    EXPECT_THROW(({ bounded_int<0, 3> out_of_range(integer_traits<int64_t>::const_min); }),
+                 boost::negative_overflow_detected);
+
+    bounded_int<-10, 10> const widened = offset;
+    EXPECT_EQ(3, widened.value());
+}
+
+TEST(verified_intBounded_TDD, ResultBounds) {
+    bounded_int<0, 255> const channel(200);
+    bounded_int<0, 3> const offset(2);
+
+    typedef bounded_int<0, 258> sum_type;
+    sum_type const sum = channel + offset;
+    EXPECT_EQ(202U, sum.value());
+
+    typedef bounded_int<-3, 255> difference_type;
+    difference_type const difference = channel - offset;
+    EXPECT_EQ(198, difference.value());
+    EXPECT_EQ(-198, (offset - channel + channel - channel).value());
+
+    typedef bounded_int<0, 765> product_type;
+    product_type const product = channel * offset;
+    EXPECT_EQ(400U, product.value());
+
+    bounded_int<-4, 3> const signed_value(-4);
+    typedef bounded_int<-12, 16> signed_product_type;
+    signed_product_type const signed_product = signed_value * bounded_int<-4, 3>(-4);
+    EXPECT_EQ(16, signed_product.value());
+
+    typedef bounded_int<-255, 0> negated_type;
+    negated_type const negated = -channel;
+    EXPECT_EQ(-200, negated.value());
+}
+
+TEST(verified_intBounded_TDD, BoundsAtTheLimits) {
+    bounded_int<integer_traits<int64_t>::const_min, integer_traits<int64_t>::const_max> const wide(
+        integer_traits<int64_t>::const_min);
+    bounded_int<0, 0> const zero(0);
+    EXPECT_EQ(integer_traits<int64_t>::const_min, (wide + zero).value());
+    EXPECT_EQ(0, (wide * zero).value());
+
+    bounded_int<-2147483648LL, 2147483647LL> const half(integer_traits<int32_t>::const_min);
+    EXPECT_EQ(int64_t(1) << 62, (half * half * bounded_int<1, 1>(1)).value());
+    EXPECT_EQ(-(int64_t(1) << 62), (-half * half).value());
+}
+
+TEST(verified_intBounded_TDD, Comparison) {
+    bounded_int<0, 255> const channel(200);
+    bounded_int<-1000, 1000> const other(200);
+    EXPECT_TRUE(channel == other);
+    EXPECT_FALSE(channel != other);
+    EXPECT_TRUE(channel <= other);
+    EXPECT_TRUE(-channel < other);
+    EXPECT_TRUE(channel > -other);
+    EXPECT_TRUE(channel >= other);
+}
+
+TEST(verified_intBounded_TDD, ConversionToVerifiedInt) {
+    bounded_int<0, 255> const channel(255);
+    bounded_int<0, 3> const offset(3);
+
+    verified_int32_t const index = channel * bounded_int<4, 4>(4) + offset;
+    EXPECT_EQ(1023, index);
+
+    // The range exceeds uint8_t, so the value is verified.
+    verified_uint8_t narrow = channel;
+    EXPECT_EQ(255U, narrow);
+    EXPECT_THROW(narrow = channel + offset, boost::positive_overflow_detected);
+    EXPECT_THROW(narrow = offset - channel, boost::negative_overflow_detected);
+    EXPECT_NO_THROW(narrow = channel - offset);
+    EXPECT_EQ(252U, narrow);
+
+    verified_int<uint8_t, saturate_overflow> const saturated = channel + offset;
+    EXPECT_EQ(255U, saturated);
+}
+} // namespace anonymous
@@ -0,0 +1,273 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_charconv.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_from_chars;
+using boost::verified_from_chars_result;
+using boost::verified_to_chars;
+using boost::verified_to_chars_result;
+using boost::verified_chars;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::e_no_overflow_detected;
+using boost::e_positive_overflow_detected;
+using boost::e_negative_overflow_detected;
+using boost::verified_int8_t;
+using boost::verified_int64_t;
+using boost::verified_uint16_t;
+
+// Numbers of up to 25 digits in base, with and without leading zeros, signs, and trailing
+// characters which are not digits.
+std::vector<std::string> numbers(int const base)
+{
+    char const digits[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::vector<std::string> texts;
+    uint64_t mixed = 0x9E3779B97F4A7C15ULL;
+    for (std::size_t index = 0; index < 3000; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::string text;
+        if ((mixed >> 60) % 3 == 0) {
+            text += '-';
+        }
+        if ((mixed >> 56) % 5 == 0) {
+            text.append((mixed >> 50) % 12, '0');
+        }
+        std::size_t const length = 1 + (mixed >> 32) % 25;
+        for (std::size_t digit = 0; digit < length; ++digit) {
+            mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+            // Mostly the highest digit, to reach the limits of each type.
+            std::size_t const value = (mixed >> 61) < 3 ? base - 1 : (mixed >> 33) % base;
+            text += (mixed >> 40) % 2 == 0 ? digits[value] : digits[value + (value >= 10 ? 26 : 0)];
+        }
+        if ((mixed >> 44) % 4 == 0) {
+            text += base < 36 ? 'z' : '!';
+        }
+        texts.push_back(text);
+    }
+    char const *const fixed[] = { "", "-", "x", "0", "-0", "00000000000000000000000000001", "127", "128", "-128",
+                                  "-129", "255", "256", "32767", "32768", "-32768", "65535", "65536",
+                                  "2147483647", "2147483648", "-2147483649", "4294967295", "4294967296",
+                                  "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+                                  "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+                                  "184467440737095516150", "12345678x", "123456789012345678901234" };
+    texts.insert(texts.end(), fixed, fixed + sizeof(fixed) / sizeof(fixed[0]));
+    return texts;
+}
+
+// Parses text with strtoll or strtoull, saturating at the limits of T, and returns the
+// number of characters parsed.
+template <typename T>
+std::size_t reference_parse(std::string const & text, int const base, T &value, bool &overflowed)
+{
+    char const *const first = text.c_str();
+    char *end = 0;
+    errno = 0;
+    if (integer_traits<T>::is_signed) {
+        long long const parsed = std::strtoll(first, &end, base);
+        verified_int<T, saturate_overflow> const saturated(static_cast<int64_t>(parsed));
+        value = saturated;
+        overflowed = errno == ERANGE || saturated != static_cast<int64_t>(parsed);
+    } else {
+        // strtoull negates numbers with a sign, which T rejects.
+        if (!text.empty() && text[0] == '-') {
+            return 0;
+        }
+        unsigned long long const parsed = std::strtoull(first, &end, base);
+        verified_int<T, saturate_overflow> const saturated(static_cast<uint64_t>(parsed));
+        value = saturated;
+        overflowed = errno == ERANGE || saturated != static_cast<uint64_t>(parsed);
+    }
+    return static_cast<std::size_t>(end - first);
+}
+
+template <typename T>
+void expect_matches_reference(int const base)
+{
+    std::vector<std::string> const texts = numbers(base);
+    for (std::size_t index = 0; index < texts.size(); ++index) {
+        std::string const & text = texts[index];
+        T expected = 0;
+        bool overflowed = false;
+        std::size_t const length = reference_parse<T>(text, base, expected, overflowed);
+
+        verified_int<T, saturate_overflow> saturated(T(7));
+        verified_from_chars_result const parsed =
+            verified_from_chars(text.data(), text.data() + text.size(), saturated, base);
+        ASSERT_EQ(length, static_cast<std::size_t>(parsed.ptr - text.data())) << text;
+        if (length == 0) {
+            EXPECT_EQ(T(7), saturated) << text;
+            continue;
+        }
+        EXPECT_EQ(expected, saturated) << text;
+        EXPECT_EQ(overflowed, parsed.result != e_no_overflow_detected) << text;
+        if (overflowed) {
+            EXPECT_EQ(expected == integer_traits<T>::const_max ? e_positive_overflow_detected
+                                                                : e_negative_overflow_detected, parsed.result) << text;
+        }
+
+        verified_int<T, throw_overflow> thrown;
+        if (overflowed) {
+            EXPECT_THROW(verified_from_chars(text.data(), text.data() + text.size(), thrown, base),
+                         boost::overflow_detected) << text;
+        } else {
+            verified_from_chars(text.data(), text.data() + text.size(), thrown, base);
+            EXPECT_EQ(expected, thrown) << text;
+        }
+    }
+}
+
+template <typename T>
+void expect_bases_match_reference()
+{
+    int const bases[] = { 10, 16, 2, 8, 36 };
+    for (std::size_t base = 0; base < sizeof(bases) / sizeof(bases[0]); ++base) {
+        expect_matches_reference<T>(bases[base]);
+    }
+}
+
+TEST(verified_intCharconv_TDD, MatchesStrtoll) {
+    expect_bases_match_reference<uint8_t>();
+    expect_bases_match_reference<uint16_t>();
+    expect_bases_match_reference<uint32_t>();
+    expect_bases_match_reference<uint64_t>();
+    expect_bases_match_reference<int8_t>();
+    expect_bases_match_reference<int16_t>();
+    expect_bases_match_reference<int32_t>();
+    expect_bases_match_reference<int64_t>();
+}
+
+TEST(verified_intCharconv_TDD, IgnoreWraps) {
+    verified_int<uint8_t, ignore_overflow> wrapped;
+    std::string const text = "300,";
+    verified_from_chars_result const parsed = verified_from_chars(text.data(), text.data() + text.size(), wrapped);
+    EXPECT_EQ(44U, wrapped);
+    EXPECT_EQ(e_no_overflow_detected, parsed.result);
+    EXPECT_EQ(',', *parsed.ptr);
+
+    verified_int<int64_t, ignore_overflow> wide;
+    std::string const huge = "-18446744073709551617";
+    verified_from_chars(huge.data(), huge.data() + huge.size(), wide);
+    EXPECT_EQ(-1, wide);
+}
+
+TEST(verified_intCharconv_TDD, StopsAtFirstNonDigit) {
+    std::string const text = "-12345678901234567x9";
+    verified_int64_t value;
+    verified_from_chars_result const parsed = verified_from_chars(text.data(), text.data() + text.size(), value);
+    EXPECT_EQ(-12345678901234567LL, value);
+    EXPECT_EQ('x', *parsed.ptr);
+
+    verified_uint16_t hexadecimal;
+    std::string const hex = "fFfF";
+    EXPECT_EQ(hex.data() + 4, verified_from_chars(hex.data(), hex.data() + 4, hexadecimal, 16).ptr);
+    EXPECT_EQ(65535U, hexadecimal);
+
+    // Only signed types have a sign.
+    std::string const negative = "-1";
+    EXPECT_EQ(negative.data(), verified_from_chars(negative.data(), negative.data() + 2, hexadecimal).ptr);
+    verified_int8_t small;
+    std::string const limit = "-10000000";
+    verified_from_chars(limit.data(), limit.data() + limit.size(), small, 2);
+    EXPECT_EQ(-128, small);
+    std::string const beyond = "-10000001";
+    EXPECT_THROW(verified_from_chars(beyond.data(), beyond.data() + beyond.size(), small, 2),
+                 boost::negative_overflow_detected);
+    EXPECT_EQ(-128, small);
+}
+// Writes every value of a sample of T in base, and parses it back.
+template <typename T>
+void expect_round_trips(int const base)
+{
+    std::vector<T> values;
+    for (unsigned int shift = 0; shift < sizeof(T) * 8; ++shift) {
+        T const power = static_cast<T>(T(1) << shift);
+        values.push_back(power);
+        values.push_back(static_cast<T>(power - 1));
+        values.push_back(static_cast<T>(0 - power));
+        values.push_back(static_cast<T>(power * 5 / 3));
+    }
+    values.push_back(integer_traits<T>::const_max);
+    values.push_back(integer_traits<T>::const_min);
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        verified_int<T, throw_overflow> const value(values[index]);
+        char buffer[sizeof(T) * 8 + 1];
+        verified_to_chars_result const written = verified_to_chars(buffer, buffer + sizeof(buffer), value, base);
+        ASSERT_TRUE(written.fits);
+        verified_int<T, throw_overflow> parsed;
+        EXPECT_EQ(written.ptr, verified_from_chars(buffer, written.ptr, parsed, base).ptr);
+        EXPECT_EQ(T(value), T(parsed)) << std::string(buffer, written.ptr);
+
+        // Too small by one character.
+        std::ptrdiff_t const length = written.ptr - buffer;
+        char small[sizeof(buffer)];
+        verified_to_chars_result const too_long = verified_to_chars(small, small + length - 1, value, base);
+        EXPECT_FALSE(too_long.fits);
+        EXPECT_EQ(small + length - 1, too_long.ptr);
+    }
+}
+
+template <typename T>
+void expect_to_chars_matches_printf()
+{
+    std::vector<T> values;
+    values.push_back(integer_traits<T>::const_max);
+    values.push_back(integer_traits<T>::const_min);
+    uint64_t mixed = 12345U;
+    for (std::size_t index = 0; index < 1000; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        values.push_back(static_cast<T>(static_cast<T>(mixed) >> ((mixed >> 58) % (8 * sizeof(T)))));
+    }
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        char expected[32];
+        if (integer_traits<T>::is_signed) {
+            std::sprintf(expected, "%lld", static_cast<long long>(values[index]));
+        } else {
+            std::sprintf(expected, "%llu", static_cast<unsigned long long>(values[index]));
+        }
+        char buffer[verified_chars<T>::size];
+        verified_to_chars_result const written =
+            verified_to_chars(buffer, buffer + sizeof(buffer), verified_int<T, saturate_overflow>(values[index]));
+        ASSERT_TRUE(written.fits);
+        EXPECT_EQ(std::string(expected), std::string(buffer, written.ptr));
+    }
+    int const bases[] = { 10, 16, 2, 8, 36 };
+    for (std::size_t base = 0; base < sizeof(bases) / sizeof(bases[0]); ++base) {
+        expect_round_trips<T>(bases[base]);
+    }
+}
+
+TEST(verified_intCharconv_TDD, ToChars) {
+    expect_to_chars_matches_printf<uint8_t>();
+    expect_to_chars_matches_printf<uint16_t>();
+    expect_to_chars_matches_printf<uint32_t>();
+    expect_to_chars_matches_printf<uint64_t>();
+    expect_to_chars_matches_printf<int8_t>();
+    expect_to_chars_matches_printf<int16_t>();
+    expect_to_chars_matches_printf<int32_t>();
+    expect_to_chars_matches_printf<int64_t>();
+
+    char buffer[4];
+    EXPECT_FALSE(verified_to_chars(buffer, buffer, verified_int8_t(-1)).fits);
+    verified_to_chars_result const written = verified_to_chars(buffer, buffer + 4, verified_int8_t(-128));
+    EXPECT_EQ("-128", std::string(buffer, written.ptr));
+    EXPECT_EQ("ff", std::string(buffer, verified_to_chars(buffer, buffer + 4, verified_uint16_t(255U), 16).ptr));
+}
+} // namespace anonymous
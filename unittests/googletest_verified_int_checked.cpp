@@ -0,0 +1,181 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include "verified_int.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::checked_result;
+using boost::checked_add;
+using boost::checked_sub;
+using boost::checked_mul;
+using boost::checked_div;
+using boost::checked_convert;
+using boost::verified_int;
+using boost::verified_uint8_t;
+using boost::verified_uint32_t;
+using boost::verified_int32_t;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::e_no_overflow_detected;
+using boost::e_positive_overflow_detected;
+using boost::e_negative_overflow_detected;
+
+BOOST_STATIC_ASSERT(boost::has_trivial_copy<checked_result<int64_t> >::value);
+BOOST_STATIC_ASSERT(sizeof(checked_result<int32_t>) <= 2 * sizeof(int32_t));
+
+TEST(verified_intChecked_TDD, Add) {
+    checked_result<uint8_t> sum = checked_add(uint8_t(200U), 55);
+    EXPECT_EQ(e_no_overflow_detected, sum.result);
+    EXPECT_EQ(255U, sum.value);
+
+    sum = checked_add(uint8_t(200U), 56);
+    EXPECT_EQ(e_positive_overflow_detected, sum.result);
+    EXPECT_EQ(0U, sum.value);
+
+    sum = checked_add(uint8_t(2U), -3);
+    EXPECT_EQ(e_negative_overflow_detected, sum.result);
+    EXPECT_EQ(255U, sum.value);
+
+    checked_result<int64_t> const wide = checked_add(integer_traits<int64_t>::const_max, uint8_t(1U));
+    EXPECT_EQ(e_positive_overflow_detected, wide.result);
+    EXPECT_EQ(integer_traits<int64_t>::const_min, wide.value);
+}
+
+TEST(verified_intChecked_TDD, Subtract) {
+    checked_result<int32_t> difference = checked_sub(integer_traits<int32_t>::const_min, 1);
+    EXPECT_EQ(e_negative_overflow_detected, difference.result);
+    EXPECT_EQ(integer_traits<int32_t>::const_max, difference.value);
+
+    difference = checked_sub(-5, -7);
+    EXPECT_EQ(e_no_overflow_detected, difference.result);
+    EXPECT_EQ(2, difference.value);
+
+    checked_result<uint32_t> const unsigned_difference = checked_sub(uint32_t(3U), int64_t(4));
+    EXPECT_EQ(e_negative_overflow_detected, unsigned_difference.result);
+    EXPECT_EQ(integer_traits<uint32_t>::const_max, unsigned_difference.value);
+}
+
+TEST(verified_intChecked_TDD, Multiply) {
+    checked_result<uint16_t> product = checked_mul(uint16_t(65535U), uint16_t(65535U));
+    EXPECT_EQ(e_positive_overflow_detected, product.result);
+    EXPECT_EQ(1U, product.value);
+
+    product = checked_mul(uint16_t(255U), uint16_t(257U));
+    EXPECT_EQ(e_no_overflow_detected, product.result);
+    EXPECT_EQ(65535U, product.value);
+
+    checked_result<int64_t> const wide = checked_mul(int64_t(1) << 62, -3);
+    EXPECT_EQ(e_negative_overflow_detected, wide.result);
+    EXPECT_EQ(int64_t(1) << 62, wide.value);
+}
+
+// A constant operand, as sizeof(T) in count * sizeof(T), is detected by comparing the other
+// operand with a quotient, which must agree with the full product.
+TEST(verified_intChecked_TDD, MultiplyByConstant) {
+    uint64_t const largest = integer_traits<uint64_t>::const_max / 24U;
+    EXPECT_EQ(e_no_overflow_detected, checked_mul(largest, uint64_t(24U)).result);
+    EXPECT_EQ(e_positive_overflow_detected, checked_mul(largest + 1U, uint64_t(24U)).result);
+    EXPECT_EQ(e_positive_overflow_detected, checked_mul(uint64_t(24U), largest + 1U).result);
+
+    volatile uint64_t const factor = 24U;
+    uint64_t const counts[] = { 0U, 1U, largest - 1U, largest, largest + 1U, integer_traits<uint64_t>::const_max };
+    for (std::size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        EXPECT_EQ(checked_mul(counts[i], uint64_t(factor)).result, checked_mul(counts[i], uint64_t(24U)).result);
+        EXPECT_EQ(checked_mul(uint64_t(factor), counts[i]).result, checked_mul(uint64_t(24U), counts[i]).result);
+        int64_t const count = static_cast<int64_t>(counts[i] / 2U);
+        EXPECT_EQ(checked_mul(count, int64_t(factor)).result, checked_mul(count, int64_t(24)).result);
+        EXPECT_EQ(checked_mul(-count, int64_t(factor)).result, checked_mul(-count, int64_t(24)).result);
+        EXPECT_EQ(checked_mul(count, -int64_t(factor)).result, checked_mul(count, int64_t(-24)).result);
+    }
+    EXPECT_EQ(e_negative_overflow_detected, checked_mul(-static_cast<int64_t>(largest / 2U + 1U), int64_t(24)).result);
+}
+
+TEST(verified_intChecked_TDD, Divide) {
+    checked_result<int32_t> quotient = checked_div(integer_traits<int32_t>::const_min, -1);
+    EXPECT_EQ(e_positive_overflow_detected, quotient.result);
+    EXPECT_EQ(integer_traits<int32_t>::const_min, quotient.value);
+
+    quotient = checked_div(-7, 2);
+    EXPECT_EQ(e_no_overflow_detected, quotient.result);
+    EXPECT_EQ(-3, quotient.value);
+
+    // Mixed signs divide as the built-in does, where -1 converts to the unsigned maximum.
+    checked_result<uint32_t> const unsigned_quotient = checked_div(5U, -1);
+    EXPECT_EQ(e_no_overflow_detected, unsigned_quotient.result);
+    EXPECT_EQ(5U / -1, unsigned_quotient.value);
+    checked_result<uint64_t> const wide_quotient = checked_div(uint64_t(7U), int8_t(-1));
+    EXPECT_EQ(e_no_overflow_detected, wide_quotient.result);
+    EXPECT_EQ(0U, wide_quotient.value);
+    EXPECT_EQ(uint8_t(uint8_t(5U) / -1), checked_div(uint8_t(5U), -1).value);
+    checked_result<int8_t> const negated = checked_div(integer_traits<int8_t>::const_min, int64_t(-1));
+    EXPECT_EQ(e_positive_overflow_detected, negated.result);
+    EXPECT_EQ(integer_traits<int8_t>::const_min, negated.value);
+
+    verified_uint32_t dividend(5U);
+    EXPECT_EQ(e_no_overflow_detected, dividend.try_div(-1));
+    EXPECT_EQ(0U, dividend);
+    verified_uint32_t divided(5U);
+    divided /= -1;
+    EXPECT_EQ(0U, divided);
+}
+
+TEST(verified_intChecked_TDD, Convert) {
+    checked_result<uint8_t> converted = checked_convert<uint8_t>(256);
+    EXPECT_EQ(e_positive_overflow_detected, converted.result);
+    EXPECT_EQ(0U, converted.value);
+
+    converted = checked_convert<uint8_t>(int64_t(-1));
+    EXPECT_EQ(e_negative_overflow_detected, converted.result);
+
+    converted = checked_convert<uint8_t>(uint64_t(255U));
+    EXPECT_EQ(e_no_overflow_detected, converted.result);
+    EXPECT_EQ(255U, converted.value);
+}
+
+TEST(verified_intChecked_TDD, TryOperations) {
+    verified_uint8_t value(250U);
+    EXPECT_EQ(e_no_overflow_detected, value.try_add(5U));
+    EXPECT_EQ(255U, value);
+    EXPECT_EQ(e_positive_overflow_detected, value.try_add(1U));
+    EXPECT_EQ(255U, value);
+
+    EXPECT_EQ(e_negative_overflow_detected, value.try_sub(256));
+    EXPECT_EQ(255U, value);
+    EXPECT_EQ(e_no_overflow_detected, value.try_sub(250));
+    EXPECT_EQ(5U, value);
+
+    EXPECT_EQ(e_positive_overflow_detected, value.try_mul(52));
+    EXPECT_EQ(5U, value);
+    EXPECT_EQ(e_negative_overflow_detected, value.try_mul(-1));
+    EXPECT_EQ(e_no_overflow_detected, value.try_mul(51));
+    EXPECT_EQ(255U, value);
+
+    verified_int32_t signed_value(integer_traits<int32_t>::const_min);
+    EXPECT_EQ(e_positive_overflow_detected, signed_value.try_div(-1));
+    EXPECT_EQ(integer_traits<int32_t>::const_min, signed_value);
+    EXPECT_EQ(e_no_overflow_detected, signed_value.try_div(int64_t(-2)));
+    EXPECT_EQ(int32_t(1) << 30, signed_value);
+}
+
+TEST(verified_intChecked_TDD, TryUsesPolicyDetection) {
+    verified_int<uint8_t, saturate_overflow> saturated(255U);
+    EXPECT_EQ(e_positive_overflow_detected, saturated.try_add(1U));
+    EXPECT_EQ(255U, saturated);
+
+    // ignore_overflow detects nothing, so the value wraps.
+    verified_int<uint8_t, ignore_overflow> ignored(255U);
+    EXPECT_EQ(e_no_overflow_detected, ignored.try_add(1U));
+    EXPECT_EQ(0U, ignored);
+}
+} // namespace anonymous
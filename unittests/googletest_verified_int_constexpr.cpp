@@ -0,0 +1,83 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/config.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::saturate_overflow;
+using boost::verified_uint8_t;
+using boost::verified_uint16_t;
+using boost::verified_int32_t;
+using boost::verified_int64_t;
+
+#if !defined(BOOST_NO_CXX14_CONSTEXPR)
+
+// Each of these is evaluated by the compiler.  Overflowing a throw_overflow value in
+// a constant expression, such as constexpr verified_uint8_t(256U), fails to compile.
+BOOST_CONSTEXPR verified_uint16_t kMax(4096U);
+BOOST_STATIC_ASSERT(kMax == 4096U);
+
+BOOST_CONSTEXPR verified_int32_t kDefault;
+BOOST_STATIC_ASSERT(kDefault == 0);
+
+BOOST_CXX14_CONSTEXPR verified_uint16_t page_count(verified_uint16_t const bytes) {
+    return (bytes + verified_uint16_t(4095U)) / verified_uint16_t(4096U);
+}
+BOOST_STATIC_ASSERT(page_count(kMax) == 1U);
+BOOST_STATIC_ASSERT(page_count(verified_uint16_t(4097U)) == 2U);
+
+BOOST_CXX14_CONSTEXPR verified_int64_t accumulate(int32_t const count) {
+    verified_int64_t total(0);
+    for (int32_t i = 0; i < count; ++i) {
+        total += i;
+        ++total;
+    }
+    total -= 5;
+    total *= -3;
+    return total;
+}
+BOOST_STATIC_ASSERT(accumulate(10) == -150);
+
+BOOST_CXX14_CONSTEXPR uint8_t saturated_sum(uint8_t const left, uint8_t const right) {
+    verified_int<uint8_t, saturate_overflow> sum(left);
+    sum += right;
+    return sum;
+}
+BOOST_STATIC_ASSERT(saturated_sum(200U, 100U) == 255U);
+BOOST_STATIC_ASSERT(saturated_sum(20U, 100U) == 120U);
+
+BOOST_STATIC_ASSERT(verified_int<int8_t, saturate_overflow>(-1000) == integer_traits<int8_t>::const_min);
+BOOST_STATIC_ASSERT(verified_int<int16_t, saturate_overflow>(integer_traits<int16_t>::const_max) * int16_t(2) ==
+                    integer_traits<int16_t>::const_max);
+BOOST_STATIC_ASSERT((verified_uint8_t(10U) - verified_uint8_t(3U)) == 7U);
+
+template <uint16_t Size>
+struct fixed_buffer
+{
+    enum { size = Size };
+};
+
+TEST(verified_intConstexpr_TDD, NonTypeTemplateArgument) {
+    EXPECT_EQ(4096, fixed_buffer<kMax>::size);
+    EXPECT_EQ(2, fixed_buffer<page_count(verified_uint16_t(8192U))>::size);
+}
+
+TEST(verified_intConstexpr_TDD, RuntimeOverflowStillThrows) {
+    verified_uint16_t const bytes(integer_traits<uint16_t>::const_max);
+    EXPECT_THROW(page_count(bytes), boost::positive_overflow_detected);
+}
+
+#endif // BOOST_NO_CXX14_CONSTEXPR
+} // namespace anonymous
@@ -0,0 +1,205 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int.hpp"
+#include "verified_int_counting.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::counting_overflow;
+using boost::overflow_counters;
+using boost::saturate_overflow;
+using boost::e_no_overflow_detected;
+using boost::e_positive_overflow_detected;
+using boost::e_negative_overflow_detected;
+using boost::e_assignment_operation;
+using boost::e_addition_operation;
+using boost::e_subtraction_operation;
+using boost::e_multiplication_operation;
+
+typedef counting_overflow<saturate_overflow> counting_saturate;
+typedef counting_overflow<> counting_ignore;
+
+TEST(verified_intCounting_TDD, CountsEachOperation) {
+    overflow_counters::reset();
+    verified_int<uint8_t, counting_saturate> value(250U);
+    value += 3U;
+    EXPECT_EQ(0U, overflow_counters::total());
+
+    value += 10U;
+    value += int32_t(10);
+    value += int32_t(10);
+    EXPECT_EQ(255U, value) << ::test_system::toStdString(value);
+    EXPECT_EQ(1U, (overflow_counters::count<uint8_t, uint32_t>(e_addition_operation, e_positive_overflow_detected)));
+    EXPECT_EQ(2U, (overflow_counters::count<uint8_t, int32_t>(e_addition_operation, e_positive_overflow_detected)));
+
+    value -= 300;
+    EXPECT_EQ(0U, value) << ::test_system::toStdString(value);
+    EXPECT_EQ(1U, (overflow_counters::count<uint8_t, int32_t>(e_subtraction_operation, e_negative_overflow_detected)));
+
+    verified_int<int16_t, counting_saturate> const converted(-100000);
+    EXPECT_EQ(integer_traits<int16_t>::const_min, converted);
+    EXPECT_EQ(1U, (overflow_counters::count<int16_t, int32_t>(e_assignment_operation, e_negative_overflow_detected)));
+    EXPECT_EQ(5U, overflow_counters::total());
+
+    overflow_counters::reset();
+    EXPECT_EQ(0U, overflow_counters::total());
+}
+
+TEST(verified_intCounting_TDD, IgnoreStillDetects) {
+    overflow_counters::reset();
+    verified_int<int32_t, counting_ignore> value(integer_traits<int32_t>::const_max / 2 + 1);
+    value *= 2;
+    EXPECT_EQ(integer_traits<int32_t>::const_min, value);
+    EXPECT_EQ(1U, (overflow_counters::count<int32_t, int32_t>(e_multiplication_operation, e_positive_overflow_detected)));
+}
+
+TEST(verified_intCounting_TDD, AggregatesThreads) {
+    overflow_counters::reset();
+    std::thread first([] {
+        verified_int<uint16_t, counting_saturate> value(0U);
+        for (int i = 0; i < 1000; ++i) {
+            value -= 1U;
+        }
+    });
+    first.join();
+
+    verified_int<uint16_t, counting_saturate> value(0U);
+    value -= 1U;
+    EXPECT_EQ(1001U, (overflow_counters::count<uint16_t, uint32_t>(e_subtraction_operation, e_negative_overflow_detected)));
+}
+
+TEST(verified_intCounting_TDD, Prometheus) {
+    overflow_counters::reset();
+    verified_int<uint8_t, counting_saturate> value(200U);
+    value += int32_t(100);
+    value += int32_t(100);
+
+    std::ostringstream out;
+    overflow_counters::write_prometheus(out);
+    std::string const expected =
+        "# HELP verified_int_overflows_total Overflows detected by verified_int.\n"
+        "# TYPE verified_int_overflows_total counter\n"
+        "verified_int_overflows_total{type=\"uint8_t\",operand=\"int32_t\",operation=\"addition\",direction=\"positive\"} 2\n";
+    EXPECT_EQ(expected, out.str());
+
+    std::string const path = ::testing::TempDir() + "verified_int_counting.prom";
+    ASSERT_TRUE(overflow_counters::write_prometheus_file(path.c_str()));
+    std::ifstream in(path.c_str());
+    std::stringstream written;
+    written << in.rdbuf();
+    EXPECT_EQ(expected, written.str());
+
+    // Exporters writing the same path concurrently each write their own temporary file.
+    std::atomic<int> failures(0);
+    std::vector<std::thread> exporters;
+    for (int thread = 0; thread < 4; ++thread) {
+        exporters.push_back(std::thread([&path, &failures] {
+            for (int write = 0; write < 50; ++write) {
+                failures += overflow_counters::write_prometheus_file(path.c_str()) ? 0 : 1;
+            }
+        }));
+    }
+    for (std::size_t thread = 0; thread < exporters.size(); ++thread) {
+        exporters[thread].join();
+    }
+    EXPECT_EQ(0, failures.load());
+    std::ifstream rewritten(path.c_str());
+    std::stringstream contents;
+    contents << rewritten.rdbuf();
+    EXPECT_EQ(expected, contents.str());
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(overflow_counters::write_prometheus_file("/nonexistent/directory/verified_int.prom"));
+#if defined(BOOST_VERIFIED_INT_HAS_UNIX_SOCKETS)
+    EXPECT_FALSE(overflow_counters::write_prometheus_socket("/nonexistent/directory/verified_int.sock"));
+#endif
+}
+
+#if defined(BOOST_VERIFIED_INT_HAS_UNIX_SOCKETS)
+TEST(verified_intCounting_TDD, PrometheusSocket) {
+    overflow_counters::reset();
+    verified_int<int8_t, counting_saturate> value(-100);
+    value -= 100;
+
+    std::string const path = ::testing::TempDir() + "verified_int_counting.sock";
+    ::unlink(path.c_str());
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    int const listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE(0, listener);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr const *>(&address), sizeof(address)));
+    ASSERT_EQ(0, ::listen(listener, 1));
+
+    std::string received;
+    std::thread reader([listener, &received] {
+        int const connection = ::accept(listener, 0, 0);
+        char buffer[256];
+        ssize_t size;
+        while ((size = ::read(connection, buffer, sizeof(buffer))) > 0) {
+            received.append(buffer, static_cast<std::size_t>(size));
+        }
+        ::close(connection);
+    });
+    EXPECT_TRUE(overflow_counters::write_prometheus_socket(path.c_str()));
+    reader.join();
+    ::close(listener);
+    ::unlink(path.c_str());
+
+    EXPECT_NE(std::string::npos, received.find(
+        "verified_int_overflows_total{type=\"int8_t\",operand=\"int32_t\",operation=\"subtraction\",direction=\"negative\"} 1\n"))
+        << received;
+}
+
+// A collector which closes the connection fails the write without raising SIGPIPE.
+TEST(verified_intCounting_TDD, PrometheusSocketClosed) {
+    overflow_counters::reset();
+    verified_int<int8_t, counting_saturate> value(-100);
+    value -= 100;
+
+    std::string const path = ::testing::TempDir() + "verified_int_counting_closed.sock";
+    ::unlink(path.c_str());
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    int const listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE(0, listener);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr const *>(&address), sizeof(address)));
+    ASSERT_EQ(0, ::listen(listener, 16));
+
+    int const attempts = 200;
+    std::thread closer([listener] {
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            ::close(::accept(listener, 0, 0));
+        }
+    });
+    // Whether each write fails depends on when the connection closes, and the process
+    // survives either way.
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        overflow_counters::write_prometheus_socket(path.c_str());
+    }
+    closer.join();
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+#endif
+} // namespace anonymous
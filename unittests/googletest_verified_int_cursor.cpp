@@ -0,0 +1,117 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int_cursor.hpp"
+#include "verified_int_endian.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_cursor;
+using boost::be_field;
+using boost::le_field;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+
+// A message of a big endian type and length, the body, and a little endian trailer.
+unsigned char const message[] = {
+    0x00, 0x07, 0x00, 0x00, 0x00, 0x03, 'a', 'b', 'c', 0x34, 0x12
+};
+
+TEST(verified_intCursor_TDD, ReadsLengthPrefixed) {
+    verified_cursor<throw_overflow> cursor(message, sizeof(message));
+    EXPECT_EQ(11U, cursor.size());
+    EXPECT_EQ(7U, cursor.read<be_field<uint16_t> >().value());
+    uint32_t const length = cursor.read<be_field<uint32_t> >().value();
+    EXPECT_EQ(6U, cursor.offset());
+
+    verified_cursor<throw_overflow> body = cursor.subspan(length);
+    EXPECT_EQ(3U, body.size());
+    EXPECT_EQ('a', body.read<char>());
+    EXPECT_EQ(0, std::memcmp("bc", body.take(2), 2));
+    EXPECT_TRUE(body.empty());
+    EXPECT_FALSE(body.failed());
+
+    EXPECT_EQ(9U, cursor.offset());
+    EXPECT_EQ(2U, cursor.remaining());
+    EXPECT_EQ(0x1234, cursor.read<le_field<int16_t> >().value());
+    EXPECT_TRUE(cursor.empty());
+
+    cursor.seek(2);
+    cursor.skip(4);
+    EXPECT_EQ('a', *cursor.data());
+    cursor.seek(cursor.size());
+    EXPECT_TRUE(cursor.empty());
+    EXPECT_FALSE(cursor.failed());
+
+#if defined(__cpp_lib_span)
+    verified_cursor<throw_overflow> spanned(std::as_bytes(std::span<unsigned char const>(message)));
+    EXPECT_EQ(11U, spanned.size());
+#endif
+}
+
+TEST(verified_intCursor_TDD, ThrowsPastTheEnd) {
+    verified_cursor<throw_overflow> cursor(message, sizeof(message));
+    cursor.skip(9);
+    EXPECT_THROW(cursor.read<uint32_t>(), boost::positive_overflow_detected);
+    EXPECT_TRUE(cursor.failed());
+    EXPECT_TRUE(cursor.empty());
+
+    cursor.seek(6);
+    EXPECT_THROW(cursor.subspan(6U), boost::positive_overflow_detected);
+    cursor.seek(6);
+    EXPECT_THROW(cursor.skip(integer_traits<uint64_t>::const_max), boost::positive_overflow_detected);
+    cursor.seek(6);
+    EXPECT_THROW(cursor.take(int32_t(-1)), boost::negative_overflow_detected);
+    EXPECT_THROW(cursor.seek(12), boost::positive_overflow_detected);
+    EXPECT_THROW(cursor.seek(int64_t(-6)), boost::negative_overflow_detected);
+
+    // The verified sizes check arithmetic on them.
+    cursor.seek(6);
+    EXPECT_THROW(cursor.offset() - 7U, boost::negative_overflow_detected);
+    EXPECT_THROW(cursor.remaining() + integer_traits<std::size_t>::const_max, boost::positive_overflow_detected);
+}
+
+template <class P>
+void expect_fails_at_the_end()
+{
+    verified_cursor<P> cursor(message, sizeof(message));
+    cursor.skip(2);
+    EXPECT_FALSE(cursor.failed());
+    verified_cursor<P> body = cursor.subspan(int64_t(-1));
+    EXPECT_TRUE(body.failed());
+    EXPECT_TRUE(body.empty());
+    EXPECT_TRUE(cursor.failed());
+    EXPECT_EQ(11U, cursor.offset());
+
+    cursor.seek(8);
+    EXPECT_TRUE(cursor.take(4) == 0);
+    EXPECT_EQ(0U, cursor.template read<uint8_t>());
+    EXPECT_EQ(11U, cursor.offset());
+
+    cursor.seek(8);
+    EXPECT_EQ(0x6334U, cursor.template read<be_field<uint16_t> >().value());
+    EXPECT_EQ(0U, cursor.template read<be_field<uint16_t> >().value());
+    EXPECT_TRUE(cursor.failed());
+}
+
+TEST(verified_intCursor_TDD, FailsAtTheEnd) {
+    expect_fails_at_the_end<saturate_overflow>();
+    expect_fails_at_the_end<ignore_overflow>();
+
+    verified_cursor<ignore_overflow> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.take(0) == 0);
+    EXPECT_FALSE(empty.failed());
+    EXPECT_TRUE(empty.take(1) == 0);
+    EXPECT_TRUE(empty.failed());
+}
+} // namespace anonymous
@@ -0,0 +1,215 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_delta.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::delta_encoder;
+using boost::delta_decoder;
+using boost::delta_of_delta_encoder;
+using boost::delta_of_delta_decoder;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+
+// Increasing values from the middle of the range of T, in steps of up to step.
+template <typename T>
+std::vector<T> column(std::size_t const count, uint64_t const step)
+{
+    std::vector<T> values;
+    uint64_t mixed = 0x9E3779B97F4A7C15ULL;
+    T value = static_cast<T>(integer_traits<T>::const_min / 2);
+    for (std::size_t index = 0; index < count; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        value = static_cast<T>(value + static_cast<T>((mixed >> 40) % (step + 1)));
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Random deltas, which take the column out of the range of T and back.
+template <typename T>
+std::vector<T> corrupted(std::size_t const count)
+{
+    std::vector<T> deltas;
+    uint64_t mixed = 12345U;
+    for (std::size_t index = 0; index < count; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        // Rotated, so that the better high bits are also the low bits.
+        T const delta = static_cast<T>((mixed >> 32) | (mixed << 32));
+        deltas.push_back(static_cast<T>(delta >> ((mixed >> 20) % (8 * sizeof(T)))));
+    }
+    return deltas;
+}
+
+// Decodes deltas one at a time with verified_int<T, P>.
+template <typename T, class P>
+std::vector<T> sequential(std::vector<T> const &deltas)
+{
+    std::vector<T> values;
+    verified_int<T, P> running;
+    for (std::size_t index = 0; index < deltas.size(); ++index) {
+        running += deltas[index];
+        values.push_back(static_cast<T>(running));
+    }
+    return values;
+}
+
+// Decodes deltas in blocks of different sizes.
+template <class Decoder, typename T>
+std::vector<T> decode_blocks(Decoder &decoder, std::vector<T> const &deltas)
+{
+    std::vector<T> values(deltas.size());
+    std::size_t const sizes[] = { 1, 7, 300, 16, 0, 1000, 3, 513 };
+    std::size_t begin = 0;
+    for (std::size_t block = 0; begin < deltas.size(); block = (block + 1) % 8) {
+        std::size_t const size = deltas.size() - begin < sizes[block] ? deltas.size() - begin : sizes[block];
+        decoder.decode(&values[0] + begin, &deltas[0] + begin, size);
+        begin += size;
+    }
+    return values;
+}
+
+template <typename T>
+void expect_round_trips()
+{
+    std::vector<T> const values = column<T>(3000, sizeof(T) == 1 ? 0 : 9);
+    std::vector<T> deltas(values.size());
+    delta_encoder<T, throw_overflow> encoder;
+    encoder.encode(&deltas[0], &values[0], 1000);
+    encoder.encode(&deltas[0] + 1000, &values[0] + 1000, 2000);
+    EXPECT_EQ(values.back(), encoder.previous());
+    delta_decoder<T, throw_overflow> decoder;
+    EXPECT_TRUE(values == decode_blocks(decoder, deltas));
+    EXPECT_EQ(values.back(), decoder.previous());
+
+}
+
+template <typename T>
+void expect_deltas_of_deltas_round_trip()
+{
+    std::vector<T> const values = column<T>(3000, sizeof(T) == 1 ? 0 : 9);
+    std::vector<T> deltas_of_deltas(values.size());
+    delta_of_delta_encoder<T, throw_overflow> encoder;
+    encoder.encode(&deltas_of_deltas[0], &values[0], values.size());
+    delta_of_delta_decoder<T, throw_overflow> decoder;
+    EXPECT_TRUE(values == decode_blocks(decoder, deltas_of_deltas));
+    EXPECT_EQ(values.back(), decoder.previous());
+}
+
+TEST(verified_intDelta_TDD, RoundTrips) {
+    expect_round_trips<uint8_t>();
+    expect_round_trips<uint16_t>();
+    expect_round_trips<uint32_t>();
+    expect_round_trips<uint64_t>();
+    expect_round_trips<int8_t>();
+    expect_round_trips<int16_t>();
+    expect_round_trips<int32_t>();
+    expect_round_trips<int64_t>();
+    expect_deltas_of_deltas_round_trip<int8_t>();
+    expect_deltas_of_deltas_round_trip<int16_t>();
+    expect_deltas_of_deltas_round_trip<int32_t>();
+    expect_deltas_of_deltas_round_trip<int64_t>();
+
+    // A constant stride encodes as zeros after the first two values.
+    int64_t const timestamps[] = { 1000, 1060, 1120, 1180, 1240 };
+    int64_t encoded[5];
+    delta_of_delta_encoder<int64_t, throw_overflow> encoder;
+    encoder.encode(encoded, timestamps, 5);
+    EXPECT_EQ(1000, encoded[0]);
+    EXPECT_EQ(-940, encoded[1]);
+    EXPECT_EQ(0, encoded[2]);
+    EXPECT_EQ(0, encoded[4]);
+}
+
+template <typename T>
+void expect_overflow_matches_sequential()
+{
+    std::vector<T> const deltas = corrupted<T>(3000);
+    delta_decoder<T, saturate_overflow> saturated;
+    EXPECT_TRUE((sequential<T, saturate_overflow>(deltas) == decode_blocks(saturated, deltas)));
+    delta_decoder<T, ignore_overflow> wrapped;
+    EXPECT_TRUE((sequential<T, ignore_overflow>(deltas) == decode_blocks(wrapped, deltas)));
+
+    std::vector<T> values(deltas.size());
+    delta_decoder<T, throw_overflow> thrown;
+    EXPECT_THROW(thrown.decode(&values[0], &deltas[0], deltas.size()), boost::overflow_detected);
+
+    // Overflow of each value of a column from one, in blocks and in the remainder.
+    std::vector<T> encoded(67, T(1));
+    for (std::size_t index = 1; index < encoded.size(); ++index) {
+        std::vector<T> corrupt = encoded;
+        corrupt[index] = integer_traits<T>::const_max;
+        delta_decoder<T, saturate_overflow> decoder;
+        EXPECT_TRUE((sequential<T, saturate_overflow>(corrupt) == decode_blocks(decoder, corrupt))) << index;
+        delta_decoder<T, throw_overflow> throwing;
+        std::vector<T> decoded(corrupt.size());
+        EXPECT_THROW(throwing.decode(&decoded[0], &corrupt[0], corrupt.size()),
+                     boost::positive_overflow_detected) << index;
+    }
+}
+
+TEST(verified_intDelta_TDD, DetectsOverflow) {
+    expect_overflow_matches_sequential<uint8_t>();
+    expect_overflow_matches_sequential<uint16_t>();
+    expect_overflow_matches_sequential<uint32_t>();
+    expect_overflow_matches_sequential<uint64_t>();
+    expect_overflow_matches_sequential<int8_t>();
+    expect_overflow_matches_sequential<int16_t>();
+    expect_overflow_matches_sequential<int32_t>();
+    expect_overflow_matches_sequential<int64_t>();
+
+    // Corrupted deltas of deltas overflow the deltas before the values.
+    int64_t const deltas_of_deltas[] = { 1, integer_traits<int64_t>::const_max, 1, 0 };
+    int64_t values[4];
+    delta_of_delta_decoder<int64_t, throw_overflow> decoder;
+    EXPECT_THROW(decoder.decode(values, deltas_of_deltas, 4), boost::positive_overflow_detected);
+}
+
+TEST(verified_intDelta_TDD, EncoderDetectsOverflow) {
+    int8_t const values[] = { 100, -100, 27 };
+    int8_t deltas[3];
+    delta_encoder<int8_t, throw_overflow> thrown;
+    EXPECT_THROW(thrown.encode(deltas, values, 3), boost::negative_overflow_detected);
+    delta_encoder<int8_t, saturate_overflow> saturated;
+    saturated.encode(deltas, values, 3);
+    EXPECT_EQ(100, deltas[0]);
+    EXPECT_EQ(-128, deltas[1]);
+    EXPECT_EQ(127, deltas[2]);
+}
+
+TEST(verified_intDelta_TDD, DecodesRuns) {
+    std::vector<uint16_t> values(1000);
+    delta_decoder<uint16_t, saturate_overflow> decoder(verified_int<uint16_t, saturate_overflow>(65000U));
+    decoder.decode_run(&values[0], 5, 100);
+    EXPECT_EQ(65005U, values[0]);
+    EXPECT_EQ(65500U, values[99]);
+    decoder.decode_run(&values[0], 7, 1000);
+    EXPECT_EQ(65507U, values[0]);
+    EXPECT_EQ(65535U, values[5]);
+    EXPECT_EQ(65535U, values[999]);
+
+    std::vector<int8_t> small(300);
+    delta_decoder<int8_t, throw_overflow> falling(verified_int<int8_t, throw_overflow>(int8_t(127)));
+    falling.decode_run(&small[0], -1, 255);
+    EXPECT_EQ(-128, small[254]);
+    EXPECT_THROW(falling.decode_run(&small[0], -1, 1), boost::negative_overflow_detected);
+    falling.decode_run(&small[0], 0, 300);
+    EXPECT_EQ(-128, falling.previous());
+
+    delta_decoder<int8_t, ignore_overflow> wrapped;
+    wrapped.decode_run(&small[0], 100, 3);
+    EXPECT_EQ(44, small[2]);
+}
+} // namespace anonymous
@@ -0,0 +1,172 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <vector>
+#include <boost/exception/get_error_info.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include "verified_int_endian.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_read;
+using boost::be_field;
+using boost::le_field;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+
+TEST(verified_intEndian_TDD, FieldsAreBytes) {
+    EXPECT_EQ(4U, sizeof(be_field<uint32_t>));
+    EXPECT_EQ(8U, sizeof(le_field<int64_t>));
+    EXPECT_EQ(1U, boost::alignment_of<be_field<uint64_t> >::value);
+
+    be_field<uint32_t> big;
+    big.store(0x01020304U);
+    EXPECT_EQ(0x01, big.bytes[0]);
+    EXPECT_EQ(0x04, big.bytes[3]);
+    EXPECT_EQ(0x01020304U, big.value());
+
+    le_field<int16_t> little;
+    little.store(-2);
+    EXPECT_EQ(0xFE, little.bytes[0]);
+    EXPECT_EQ(0xFF, little.bytes[1]);
+    EXPECT_EQ(-2, little.value());
+
+    // Overlaid on unaligned bytes.
+    unsigned char const bytes[] = { 0xAA, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    be_field<int64_t> const &field = *reinterpret_cast<be_field<int64_t> const *>(bytes + 1);
+    EXPECT_EQ(integer_traits<int64_t>::const_min + 1, field.value());
+}
+
+TEST(verified_intEndian_TDD, ReadsVerifiedInt) {
+    be_field<uint32_t> port;
+    port.store(70000U);
+    EXPECT_THROW((verified_read<uint16_t, throw_overflow>(port)), boost::positive_overflow_detected);
+    EXPECT_EQ(65535U, (verified_read<uint16_t, saturate_overflow>(port)));
+    EXPECT_EQ(uint16_t(70000U), (verified_read<uint16_t, ignore_overflow>(port)));
+    EXPECT_EQ(70000U, (verified_read<uint32_t, throw_overflow>(port)));
+
+    le_field<int32_t> offset;
+    offset.store(-1);
+    EXPECT_THROW((verified_read<uint64_t, throw_overflow>(offset)), boost::negative_overflow_detected);
+    EXPECT_EQ(-1, (verified_read<int8_t, throw_overflow>(offset)));
+}
+
+// Records of a field followed by padding, so that the fields are stride bytes apart.
+template <class Field>
+std::vector<unsigned char> records(std::size_t const count, std::size_t const stride, std::size_t const offending)
+{
+    typedef typename Field::value_type T;
+    std::vector<unsigned char> bytes(count * stride + 1, 0xCC);
+    uint64_t mixed = 0x9E3779B97F4A7C15ULL;
+    for (std::size_t index = 0; index < count; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        // Mostly small values of either sign, and one in offending out of any range.
+        T value = static_cast<T>((mixed >> 40) % 100);
+        if ((mixed >> 20) % 3 == 0) {
+            value = static_cast<T>(0 - value);
+        }
+        if (offending != 0 && (mixed >> 32) % offending == 0) {
+            value = static_cast<T>(mixed >> 8);
+        }
+        // Starting at an odd address.
+        reinterpret_cast<Field *>(&bytes[1 + index * stride])->store(value);
+    }
+    return bytes;
+}
+
+template <typename V, class P, class Field>
+void expect_bulk_matches_scalar(std::size_t const stride, std::size_t const offending)
+{
+    std::size_t const count = 1000;
+    std::vector<unsigned char> const bytes = records<Field>(count, stride, offending);
+    Field const *const first = reinterpret_cast<Field const *>(&bytes[1]);
+    std::vector<V> converted(count);
+    verified_read<V, P>(&converted[0], first, stride, count);
+    for (std::size_t index = 0; index < count; ++index) {
+        Field const &field = *reinterpret_cast<Field const *>(&bytes[1 + index * stride]);
+        EXPECT_EQ(static_cast<V>(verified_read<V, P>(field)), converted[index]) << index;
+    }
+}
+
+template <typename V, class Field>
+void expect_bulk_matches_scalar()
+{
+    std::size_t const strides[] = { sizeof(Field), sizeof(Field) + 3, 16 };
+    std::size_t const offendings[] = { 0, 7, 200 };
+    for (std::size_t stride = 0; stride < 3; ++stride) {
+        for (std::size_t offending = 0; offending < 3; ++offending) {
+            expect_bulk_matches_scalar<V, saturate_overflow, Field>(strides[stride], offendings[offending]);
+            expect_bulk_matches_scalar<V, ignore_overflow, Field>(strides[stride], offendings[offending]);
+        }
+    }
+}
+
+TEST(verified_intEndian_TDD, BulkMatchesScalar) {
+    expect_bulk_matches_scalar<uint16_t, be_field<uint32_t> >();
+    expect_bulk_matches_scalar<uint32_t, be_field<uint32_t> >();
+    expect_bulk_matches_scalar<int32_t, be_field<uint32_t> >();
+    expect_bulk_matches_scalar<uint64_t, be_field<int64_t> >();
+    expect_bulk_matches_scalar<int64_t, be_field<int64_t> >();
+    expect_bulk_matches_scalar<int16_t, be_field<uint16_t> >();
+    expect_bulk_matches_scalar<int8_t, be_field<int16_t> >();
+    expect_bulk_matches_scalar<uint8_t, be_field<uint8_t> >();
+    expect_bulk_matches_scalar<int64_t, le_field<int32_t> >();
+    expect_bulk_matches_scalar<uint32_t, le_field<int32_t> >();
+    expect_bulk_matches_scalar<uint64_t, le_field<uint64_t> >();
+    // Unsigned fields into narrower signed values.
+    expect_bulk_matches_scalar<int16_t, be_field<uint32_t> >();
+    expect_bulk_matches_scalar<int8_t, le_field<uint16_t> >();
+    expect_bulk_matches_scalar<int32_t, le_field<uint64_t> >();
+
+    be_field<uint32_t> fields[2];
+    fields[0].store(1U);
+    fields[1].store(0xFFFF9000U);
+    int16_t values[2];
+    EXPECT_THROW((verified_read<int16_t, throw_overflow>(values, fields, sizeof(fields[0]), 2)),
+                 boost::positive_overflow_detected);
+    fields[1].store(0xFFFFFFFFU);
+    EXPECT_THROW((verified_read<int16_t, throw_overflow>(values, fields, sizeof(fields[0]), 2)),
+                 boost::positive_overflow_detected);
+    fields[1].store(0x7FFFU);
+    verified_read<int16_t, throw_overflow>(values, fields, sizeof(fields[0]), 2);
+    EXPECT_EQ(0x7FFF, values[1]);
+}
+
+TEST(verified_intEndian_TDD, BulkThrowsWithIndex) {
+    std::vector<be_field<uint32_t> > fields(300);
+    for (std::size_t index = 0; index < fields.size(); ++index) {
+        fields[index].store(static_cast<uint32_t>(index));
+    }
+    std::vector<uint8_t> converted(fields.size());
+    try {
+        verified_read<uint8_t, throw_overflow>(&converted[0], &fields[0], sizeof(fields[0]), fields.size());
+        FAIL();
+    } catch (boost::positive_overflow_detected const & e) {
+        std::size_t const *const index = boost::get_error_info<boost::overflow_index>(e);
+        ASSERT_TRUE(index != 0);
+        EXPECT_EQ(256U, *index);
+        EXPECT_EQ(255U, converted[255]);
+    }
+
+    // Packed fields whose sign changes.
+    fields[290].store(0x80000000U);
+    std::vector<int32_t> signed_values(fields.size());
+    try {
+        verified_read<int32_t, throw_overflow>(&signed_values[0], &fields[0], sizeof(fields[0]), fields.size());
+        FAIL();
+    } catch (boost::positive_overflow_detected const & e) {
+        EXPECT_EQ(290U, *boost::get_error_info<boost::overflow_index>(e));
+        EXPECT_EQ(289, signed_values[289]);
+    }
+}
+} // namespace anonymous
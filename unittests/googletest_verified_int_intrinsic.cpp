@@ -0,0 +1,174 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::with_detection;
+using boost::overflow_detection_intrinsic;
+using boost::overflow_result;
+using boost::e_no_overflow_detected;
+using boost::e_positive_overflow_detected;
+using boost::e_negative_overflow_detected;
+
+typedef with_detection<boost::throw_overflow, overflow_detection_intrinsic> throw_intrinsic;
+typedef with_detection<boost::saturate_overflow, overflow_detection_intrinsic> saturate_intrinsic;
+
+// Without the intrinsics overflow_detection_intrinsic is the portable detection, which
+// is covered by the other test files.
+#if defined(BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS)
+
+template <typename L>
+overflow_result expected_result(int64_t const exact) {
+    overflow_result result = e_no_overflow_detected;
+    if (exact > static_cast<int64_t>(integer_traits<L>::const_max)) {
+        result = e_positive_overflow_detected;
+    } else if (exact < static_cast<int64_t>(integer_traits<L>::const_min)) {
+        result = e_negative_overflow_detected;
+    }
+    return result;
+}
+
+// Compares every operation of the intrinsic detection against exact arithmetic for
+// every pair of values of two 8-bit types.
+template <typename L, typename R>
+void expect_exact_detection() {
+    typedef typename overflow_detection_intrinsic::template detection<L, R>::type detection_type;
+    for (int64_t left = integer_traits<L>::const_min; left <= integer_traits<L>::const_max; ++left) {
+        for (int64_t right = integer_traits<R>::const_min; right <= integer_traits<R>::const_max; ++right) {
+            L const l = static_cast<L>(left);
+            R const r = static_cast<R>(right);
+            ASSERT_EQ(expected_result<L>(right), detection_type::detect_overflow_assignment(r));
+            ASSERT_EQ(expected_result<L>(left + right), detection_type::detect_overflow_addition(l, r))
+                << left << " + " << right;
+            ASSERT_EQ(expected_result<L>(left - right), detection_type::detect_overflow_subtraction(l, r))
+                << left << " - " << right;
+            ASSERT_EQ(expected_result<L>(left * right), detection_type::detect_overflow_multiplication(l, r))
+                << left << " * " << right;
+        }
+    }
+}
+
+TEST(verified_intIntrinsic_TDD, ExactDetection8Bit) {
+    expect_exact_detection<uint8_t, uint8_t>();
+    expect_exact_detection<uint8_t, int8_t>();
+    expect_exact_detection<int8_t, uint8_t>();
+    expect_exact_detection<int8_t, int8_t>();
+}
+
+TEST(verified_intIntrinsic_TDD, ExactDetectionMixedWidths) {
+    expect_exact_detection<uint8_t, int16_t>();
+    expect_exact_detection<int16_t, uint8_t>();
+}
+
+TEST(verified_intIntrinsic_TDD, Assignment64Bit) {
+    EXPECT_NO_THROW(({
+        verified_int<int64_t, throw_intrinsic> var(integer_traits<int64_t>::const_min);
+    }));
+    EXPECT_THROW(({
+        verified_int<int64_t, throw_intrinsic> var(integer_traits<uint64_t>::const_max);
+    }), boost::positive_overflow_detected);
+    EXPECT_THROW(({
+        verified_int<uint64_t, throw_intrinsic> var(integer_traits<int64_t>::const_min);
+    }), boost::negative_overflow_detected);
+    EXPECT_THROW(({
+        verified_int<uint32_t, throw_intrinsic> var(-1);
+    }), boost::negative_overflow_detected);
+}
+
+TEST(verified_intIntrinsic_TDD, Addition64Bit) {
+    verified_int<int64_t, throw_intrinsic> value(integer_traits<int64_t>::const_max - 1);
+    EXPECT_NO_THROW(value += 1);
+    EXPECT_THROW(value += 1, boost::positive_overflow_detected);
+
+    value = -1;
+    EXPECT_NO_THROW(value += integer_traits<int64_t>::const_min + 1);
+    EXPECT_EQ(integer_traits<int64_t>::const_min, value);
+    EXPECT_THROW(value += -1, boost::negative_overflow_detected);
+
+    verified_int<uint64_t, throw_intrinsic> unsigned_value(5U);
+    EXPECT_NO_THROW(unsigned_value += int64_t(-5));
+    EXPECT_EQ(0U, unsigned_value);
+    EXPECT_THROW(unsigned_value += int64_t(-1), boost::negative_overflow_detected);
+}
+
+TEST(verified_intIntrinsic_TDD, Subtraction64Bit) {
+    verified_int<int64_t, throw_intrinsic> value(integer_traits<int64_t>::const_min + 1);
+    EXPECT_NO_THROW(value -= 1);
+    EXPECT_THROW(value -= 1, boost::negative_overflow_detected);
+
+    value = integer_traits<int64_t>::const_min;
+    EXPECT_THROW(value -= uint64_t(1), boost::negative_overflow_detected);
+
+    value = 1;
+    EXPECT_THROW(value -= integer_traits<int64_t>::const_min, boost::positive_overflow_detected);
+
+    verified_int<uint64_t, throw_intrinsic> unsigned_value(0U);
+    EXPECT_NO_THROW(unsigned_value -= int32_t(-7));
+    EXPECT_EQ(7U, unsigned_value);
+    EXPECT_THROW(unsigned_value -= 8, boost::negative_overflow_detected);
+}
+
+TEST(verified_intIntrinsic_TDD, Multiplication64Bit) {
+    verified_int<int64_t, throw_intrinsic> value(int64_t(1) << 31);
+    EXPECT_NO_THROW(value *= int64_t(1) << 31);
+    EXPECT_EQ(int64_t(1) << 62, value);
+    EXPECT_NO_THROW(value *= -2);
+    EXPECT_EQ(integer_traits<int64_t>::const_min, value);
+
+    value = int64_t(1) << 62;
+    EXPECT_THROW(value *= 2, boost::positive_overflow_detected);
+
+    value = int64_t(1) << 62;
+    EXPECT_THROW(value *= -3, boost::negative_overflow_detected);
+
+    verified_int<uint64_t, throw_intrinsic> unsigned_value(3U);
+    EXPECT_THROW(unsigned_value *= -1, boost::negative_overflow_detected);
+
+    unsigned_value = 3U;
+    EXPECT_THROW(unsigned_value *= integer_traits<uint64_t>::const_max / 2, boost::positive_overflow_detected);
+}
+
+TEST(verified_intIntrinsic_TDD, Division) {
+    verified_int<int8_t, throw_intrinsic> value(integer_traits<int8_t>::const_min);
+    EXPECT_THROW(value /= -1, boost::positive_overflow_detected);
+    EXPECT_NO_THROW(value /= 2);
+    EXPECT_EQ(integer_traits<int8_t>::const_min / 2, value);
+}
+
+TEST(verified_intIntrinsic_TDD, Saturate) {
+    verified_int<uint8_t, saturate_intrinsic> value(250U);
+    value += 10U;
+    EXPECT_EQ(255U, value) << ::test_system::toStdString(value);
+    value -= 300;
+    EXPECT_EQ(0U, value) << ::test_system::toStdString(value);
+
+    verified_int<int16_t, saturate_intrinsic> signed_value(-200);
+    signed_value *= 200;
+    EXPECT_EQ(integer_traits<int16_t>::const_min, signed_value) << ::test_system::toStdString(signed_value);
+    signed_value *= -1;
+    EXPECT_EQ(integer_traits<int16_t>::const_max, signed_value) << ::test_system::toStdString(signed_value);
+}
+
+TEST(verified_intIntrinsic_TDD, BinaryOperators) {
+    verified_int<uint8_t, throw_intrinsic> valueA(0xF0U);
+    verified_int<uint8_t, throw_intrinsic> valueB(0x0FU);
+    verified_int<uint8_t, throw_intrinsic> valueC(0U);
+
+    EXPECT_NO_THROW(valueC = valueA + valueB);
+    EXPECT_EQ(0xFF, valueC);
+    EXPECT_THROW(valueC = valueC + valueB, boost::positive_overflow_detected);
+    EXPECT_THROW(valueC = valueB - valueA, boost::negative_overflow_detected);
+}
+#endif // BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS
+} // namespace anonymous
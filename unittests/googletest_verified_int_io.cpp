@@ -0,0 +1,71 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <boost/integer_traits.hpp>
+#include "verified_int_io.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::saturate_overflow;
+using boost::verified_int8_t;
+using boost::verified_uint8_t;
+using boost::verified_int32_t;
+using boost::verified_int64_t;
+using boost::verified_uint64_t;
+
+TEST(verified_intIo_TDD, WritesDecimal) {
+    std::ostringstream out;
+    out << verified_int8_t(-128) << ' ' << verified_uint8_t(65U) << ' '
+        << verified_int64_t(integer_traits<int64_t>::const_min) << ' '
+        << verified_uint64_t(integer_traits<uint64_t>::const_max) << ' '
+        << verified_int<int16_t, saturate_overflow>(0);
+    EXPECT_EQ("-128 65 -9223372036854775808 18446744073709551615 0", out.str());
+}
+
+TEST(verified_intIo_TDD, HonoursFlags) {
+    std::ostringstream out;
+    out << std::hex << verified_uint8_t(255U) << ' ' << std::dec << std::setw(5) << verified_int8_t(-5) << ' '
+        << std::showpos << verified_int64_t(7) << std::noshowpos << ' '
+        << std::left << std::setw(4) << verified_uint8_t(9U) << '|';
+    EXPECT_EQ("ff    -5 +7 9   |", out.str());
+}
+
+// Negative values in hex and oct are written in the width of T, as the built-ins are.
+TEST(verified_intIo_TDD, WritesNegativeInBase) {
+    std::ostringstream out;
+    out << std::hex << verified_int32_t(-1) << ' ' << verified_int<int16_t, saturate_overflow>(-2) << ' '
+        << verified_int64_t(-1) << ' ' << verified_int8_t(-1) << ' ' << std::oct << verified_int32_t(-8) << ' '
+        << verified_int<int16_t, saturate_overflow>(-1) << ' ' << verified_int8_t(-1);
+    std::ostringstream expected;
+    expected << std::hex << int32_t(-1) << ' ' << int16_t(-2) << ' ' << int64_t(-1) << ' '
+             << unsigned(uint8_t(-1)) << ' ' << std::oct << int32_t(-8) << ' ' << int16_t(-1) << ' '
+             << unsigned(uint8_t(-1));
+    EXPECT_EQ(expected.str(), out.str());
+    EXPECT_EQ("ffffffff fffe ffffffffffffffff ff 37777777770 177777 377", out.str());
+
+    // Decimal keeps the sign of an 8-bit value.
+    std::ostringstream decimal;
+    decimal << std::showpos << verified_int8_t(-1) << ' ' << std::noshowpos << std::setw(4) << verified_int8_t(-1);
+    EXPECT_EQ("-1   -1", decimal.str());
+}
+
+#if defined(__cpp_lib_format)
+TEST(verified_intIo_TDD, Format) {
+    EXPECT_EQ("-128 18446744073709551615 [    42] 2a",
+              std::format("{} {} [{:>6}] {:x}", verified_int8_t(-128),
+                          verified_uint64_t(integer_traits<uint64_t>::const_max),
+                          verified_int64_t(42), verified_int64_t(42)));
+}
+#endif
+} // namespace anonymous
@@ -0,0 +1,107 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int_layout.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_layout;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+
+TEST(verified_intLayout_TDD, MapsIndices) {
+    int32_t const extents[] = { 2, 3, 4 };
+    verified_layout<int32_t, 3> const row_major(extents);
+    EXPECT_EQ(3U, row_major.rank());
+    EXPECT_EQ(12, row_major.stride(0));
+    EXPECT_EQ(4, row_major.stride(1));
+    EXPECT_EQ(1, row_major.stride(2));
+    EXPECT_EQ(24, row_major.required_span_size());
+    EXPECT_EQ(0, row_major(0, 0, 0));
+    EXPECT_EQ(12 + 8 + 3, row_major(1, 2, 3));
+    int32_t const indices[] = { 1, 0, 2 };
+    EXPECT_EQ(14, row_major(indices));
+    EXPECT_FALSE(row_major.failed());
+
+    verified_layout<int32_t, 3> const column_major = verified_layout<int32_t, 3>::column_major(extents);
+    EXPECT_EQ(1, column_major.stride(0));
+    EXPECT_EQ(2, column_major.stride(1));
+    EXPECT_EQ(6, column_major.stride(2));
+    EXPECT_EQ(24, column_major.required_span_size());
+    EXPECT_EQ(1 + 4 + 18, column_major(1, 2, 3));
+
+    // A tile of a wider image.
+    int32_t const tile[] = { 3, 4 };
+    int32_t const strides[] = { 10, 1 };
+    verified_layout<int32_t, 2> const strided(tile, strides);
+    EXPECT_EQ(2 * 10 + 3 + 1, strided.required_span_size());
+    EXPECT_EQ(23, strided(2, 3));
+
+    int32_t const empty_extents[] = { 5, 0, 7 };
+    EXPECT_EQ(0, (verified_layout<int32_t, 3>(empty_extents).required_span_size()));
+
+    uint16_t const largest[] = { 255, 257 };
+    verified_layout<uint16_t, 2> const narrow(largest);
+    EXPECT_EQ(65535U, narrow.required_span_size());
+    EXPECT_EQ(65534U, narrow(254, 256));
+
+    // The sizes are verified.
+    EXPECT_THROW(narrow.required_span_size() + uint16_t(1), boost::positive_overflow_detected);
+    EXPECT_THROW(narrow.extent(1) * uint16_t(256), boost::positive_overflow_detected);
+}
+
+TEST(verified_intLayout_TDD, ThrowsOnOverflow) {
+    int32_t const tensor[] = { 2000, 2000, 1000 };
+    EXPECT_THROW((verified_layout<int32_t, 3>(tensor)), boost::positive_overflow_detected);
+    EXPECT_THROW((verified_layout<int32_t, 3>::column_major(tensor)), boost::positive_overflow_detected);
+    int64_t const wide[] = { 2000, 2000, 1000 };
+    EXPECT_EQ(4000000000LL, (verified_layout<int64_t, 3>(wide).required_span_size()));
+
+    uint16_t const image[] = { 256, 256 };
+    EXPECT_THROW((verified_layout<uint16_t, 2>(image)), boost::positive_overflow_detected);
+
+    int32_t const negative[] = { 4, -1 };
+    EXPECT_THROW((verified_layout<int32_t, 2>(negative)), boost::negative_overflow_detected);
+    int32_t const extents[] = { 4, 4 };
+    EXPECT_THROW((verified_layout<int32_t, 2>(extents, negative)), boost::negative_overflow_detected);
+
+    // The strides fit, and the required span size does not.
+    int32_t const large_strides[] = { integer_traits<int32_t>::const_max / 2, 1 };
+    int32_t const pair[] = { 2, 2 };
+    EXPECT_EQ(integer_traits<int32_t>::const_max / 2 + 2,
+              (verified_layout<int32_t, 2>(pair, large_strides).required_span_size()));
+    int32_t const triple[] = { 3, 2 };
+    EXPECT_THROW((verified_layout<int32_t, 2>(triple, large_strides)), boost::positive_overflow_detected);
+    int32_t const many[] = { 4, 2 };
+    EXPECT_THROW((verified_layout<int32_t, 2>(many, large_strides)), boost::positive_overflow_detected);
+}
+
+template <class P>
+void expect_fails_empty()
+{
+    int32_t const tensor[] = { 2000, 2000, 1000 };
+    verified_layout<int32_t, 3, P> const layout(tensor);
+    EXPECT_TRUE(layout.failed());
+    EXPECT_EQ(0, layout.extent(0));
+    EXPECT_EQ(0, layout.stride(2));
+    EXPECT_EQ(0, layout.required_span_size());
+
+    int32_t const negative[] = { -1, 4, 4 };
+    EXPECT_TRUE((verified_layout<int32_t, 3, P>::column_major(negative).failed()));
+    EXPECT_FALSE((verified_layout<int32_t, 3, P>().failed()));
+}
+
+TEST(verified_intLayout_TDD, FailsEmpty) {
+    expect_fails_empty<saturate_overflow>();
+    expect_fails_empty<ignore_overflow>();
+}
+} // namespace anonymous
@@ -16,6 +16,7 @@ namespace {
 
 using boost::verified_int;
 using boost::throw_overflow;
+using boost::integer_traits;
 
 TEST(verified_intMultiplication_TDD, MultiplyZero) {
     verified_int<int8_t, throw_overflow> test(0x10);
@@ -163,4 +164,107 @@ TEST(verified_intMultiplication_TDD, UnSignedMinTimesNegOne) {
     EXPECT_EQ(lhs, 0);
 }
 
+template <typename L, typename R>
+void expect_exact_multiplication() {
+    typedef boost::do_detect_overflow<L, R> detection_type;
+    for (int32_t left = integer_traits<L>::const_min; left <= integer_traits<L>::const_max; ++left) {
+        for (int32_t right = integer_traits<R>::const_min; right <= integer_traits<R>::const_max; ++right) {
+            int32_t const product = left * right;
+            boost::overflow_result expected = boost::e_no_overflow_detected;
+            if (product > integer_traits<L>::const_max) {
+                expected = boost::e_positive_overflow_detected;
+            } else if (product < integer_traits<L>::const_min) {
+                expected = boost::e_negative_overflow_detected;
+            }
+            ASSERT_EQ(expected, detection_type::detect_overflow_multiplication(
+                static_cast<L>(left), static_cast<R>(right))) << left << " * " << right;
+        }
+    }
+}
+
+TEST(verified_intMultiplication_TDD, ExactDetection8Bit) {
+    expect_exact_multiplication<uint8_t, uint8_t>();
+    expect_exact_multiplication<uint8_t, int8_t>();
+    expect_exact_multiplication<int8_t, uint8_t>();
+    expect_exact_multiplication<int8_t, int8_t>();
+}
+
+TEST(verified_intMultiplication_TDD, Signed32EqualOperands) {
+    verified_int<int32_t, throw_overflow> value(46340);
+    EXPECT_NO_THROW(value *= 46340);
+    EXPECT_EQ(46340 * 46340, value);
+
+    value = 46341;
+    EXPECT_THROW(value *= 46341, boost::positive_overflow_detected);
+
+    value = -46341;
+    EXPECT_THROW(value *= -46341, boost::positive_overflow_detected);
+
+    value = -46341;
+    EXPECT_THROW(value *= 46341, boost::negative_overflow_detected);
+}
+
+TEST(verified_intMultiplication_TDD, Unsigned32Limits) {
+    verified_int<uint32_t, throw_overflow> value(0x10000U);
+    EXPECT_NO_THROW(value *= 0xFFFFU);
+    EXPECT_EQ(0xFFFF0000U, value);
+
+    value = 0x10000U;
+    EXPECT_THROW(value *= 0x10000U, boost::positive_overflow_detected);
+
+    value = 0x10000U;
+    EXPECT_THROW(value *= int32_t(-1), boost::negative_overflow_detected);
+}
+
+TEST(verified_intMultiplication_TDD, Signed64Limits) {
+    verified_int<int64_t, throw_overflow> value(int64_t(1) << 31);
+    EXPECT_NO_THROW(value *= int64_t(1) << 31);
+    EXPECT_NO_THROW(value *= -2);
+    EXPECT_EQ(integer_traits<int64_t>::const_min, value);
+
+    value = int64_t(1) << 62;
+    EXPECT_THROW(value *= 2, boost::positive_overflow_detected);
+
+    value = integer_traits<int64_t>::const_min;
+    EXPECT_THROW(value *= -1, boost::positive_overflow_detected);
+
+    value = int64_t(3037000500);
+    EXPECT_THROW(value *= int64_t(3037000500), boost::positive_overflow_detected);
+
+    value = int64_t(3037000499);
+    EXPECT_NO_THROW(value *= -int64_t(3037000499));
+    EXPECT_EQ(-int64_t(3037000499) * int64_t(3037000499), value);
+}
+
+TEST(verified_intMultiplication_TDD, Unsigned64Limits) {
+    verified_int<uint64_t, throw_overflow> value(0xFFFFFFFFU);
+    EXPECT_NO_THROW(value *= uint64_t(0x100000001U));
+    EXPECT_EQ(integer_traits<uint64_t>::const_max, value);
+
+    value = uint64_t(0x100000000U);
+    EXPECT_THROW(value *= uint64_t(0x100000000U), boost::positive_overflow_detected);
+
+    value = 1U;
+    EXPECT_THROW(value *= int64_t(-1), boost::negative_overflow_detected);
+
+    value = 0U;
+    EXPECT_NO_THROW(value *= integer_traits<int64_t>::const_min);
+    EXPECT_EQ(0U, value);
+}
+
+TEST(verified_intMultiplication_TDD, NarrowTimesWide) {
+    verified_int<int8_t, throw_overflow> value(-2);
+    EXPECT_NO_THROW(value *= int64_t(64));
+    EXPECT_EQ(-128, value);
+
+    value = 2;
+    EXPECT_THROW(value *= int64_t(64), boost::positive_overflow_detected);
+
+    value = 1;
+    EXPECT_THROW(value *= integer_traits<int64_t>::const_min, boost::negative_overflow_detected);
+
+    verified_int<uint16_t, throw_overflow> unsigned_value(2U);
+    EXPECT_THROW(unsigned_value *= integer_traits<uint64_t>::const_max, boost::positive_overflow_detected);
+}
+
 } // namespace anonymous
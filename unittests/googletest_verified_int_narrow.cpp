@@ -0,0 +1,136 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <algorithm>
+#include <vector>
+#include <boost/exception/get_error_info.hpp>
+#include <boost/integer_traits.hpp>
+#include "verified_int.hpp"
+#include "verified_int_narrow.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_narrow;
+using boost::overflow_index;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::with_detection;
+using boost::overflow_detection_on;
+
+// Values around the limits of T, with pseudo random values in between, in U.
+template <typename U, typename T>
+std::vector<U> narrowing_values(std::size_t const count)
+{
+    U const limits[] = {
+        static_cast<U>(integer_traits<T>::const_max), static_cast<U>(integer_traits<T>::const_min),
+        integer_traits<U>::const_max, integer_traits<U>::const_min, U(0), U(1)
+    };
+    std::vector<U> values;
+    for (std::size_t index = 0; index < count; ++index) {
+        uint64_t mixed = (index + 1) * 0x9E3779B97F4A7C15ULL;
+        mixed ^= mixed >> 31;
+        U value = static_cast<U>(mixed % 4 == 0 ? mixed : mixed % 512);
+        if (index % 5 == 0) {
+            value = static_cast<U>(limits[index / 5 % 6] + static_cast<U>(index % 3) - U(1));
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+template <typename T, class P, typename U>
+void expect_narrow_matches_verified_int()
+{
+    std::size_t const counts[] = { 0, 1, 7, 16, 17, 64, 65, 1000 };
+    std::vector<U> const source = narrowing_values<U, T>(1000);
+    for (std::size_t count_index = 0; count_index < sizeof(counts) / sizeof(counts[0]); ++count_index) {
+        std::size_t const count = counts[count_index];
+        std::vector<T> destination(count + 1, T(7));
+        verified_narrow<T, P>(&destination[0], &source[0], count);
+        for (std::size_t index = 0; index < count; ++index) {
+            ASSERT_EQ(T(verified_int<T, P>(source[index])), destination[index]) << index;
+        }
+        EXPECT_EQ(T(7), destination[count]);
+    }
+}
+
+template <typename T, typename U>
+void expect_policies_match_verified_int()
+{
+    expect_narrow_matches_verified_int<T, saturate_overflow, U>();
+    expect_narrow_matches_verified_int<T, ignore_overflow, U>();
+}
+
+TEST(verified_intNarrow_TDD, MatchesVerifiedInt) {
+    // Saturating packs.
+    expect_policies_match_verified_int<int8_t, int16_t>();
+    expect_policies_match_verified_int<uint8_t, int16_t>();
+    expect_policies_match_verified_int<int16_t, int32_t>();
+    expect_policies_match_verified_int<int8_t, int32_t>();
+    expect_policies_match_verified_int<uint8_t, int32_t>();
+    // Blocks.
+    expect_policies_match_verified_int<int16_t, int64_t>();
+    expect_policies_match_verified_int<uint8_t, int64_t>();
+    expect_policies_match_verified_int<uint16_t, int32_t>();
+    expect_policies_match_verified_int<uint8_t, uint64_t>();
+    expect_policies_match_verified_int<int32_t, uint32_t>();
+    expect_policies_match_verified_int<uint32_t, int32_t>();
+    expect_policies_match_verified_int<int64_t, int16_t>();
+}
+
+TEST(verified_intNarrow_TDD, ThrowsWithIndex) {
+    std::vector<int32_t> source(300, 1000);
+    std::vector<int16_t> destination(300);
+    EXPECT_NO_THROW((verified_narrow<int16_t, throw_overflow>(&destination[0], &source[0], source.size())));
+    EXPECT_EQ(1000, destination[299]);
+
+    source[130] = -40000;
+    source[200] = 40000;
+    try {
+        verified_narrow<int16_t, throw_overflow>(&destination[0], &source[0], source.size());
+        FAIL();
+    } catch (boost::negative_overflow_detected const & e) {
+        std::size_t const *const index = boost::get_error_info<overflow_index>(e);
+        ASSERT_TRUE(index != 0);
+        EXPECT_EQ(130U, *index);
+    }
+}
+
+TEST(verified_intNarrow_TDD, ReportsOffendingIndices) {
+    std::vector<int64_t> source(150, -5);
+    source[3] = 256;
+    source[70] = 300;
+    source[149] = 1000;
+    std::vector<uint8_t> destination(150);
+    std::vector<std::size_t> offending;
+    EXPECT_EQ(150U, (verified_narrow<uint8_t, saturate_overflow>(&destination[0], &source[0], 150, offending)));
+    EXPECT_EQ(150U, offending.size());
+
+    std::fill(source.begin(), source.end(), 5);
+    source[3] = 256;
+    source[70] = -1;
+    source[149] = 1000;
+    offending.clear();
+    typedef with_detection<ignore_overflow, overflow_detection_on> report_overflow;
+    EXPECT_EQ(3U, (verified_narrow<uint8_t, report_overflow>(&destination[0], &source[0], 150, offending)));
+    ASSERT_EQ(3U, offending.size());
+    EXPECT_EQ(3U, offending[0]);
+    EXPECT_EQ(70U, offending[1]);
+    EXPECT_EQ(149U, offending[2]);
+    EXPECT_EQ(0U, destination[3]);
+    EXPECT_EQ(255U, destination[70]);
+    EXPECT_EQ(5U, destination[0]);
+
+    offending.clear();
+    EXPECT_EQ(0U, (verified_narrow<uint8_t, ignore_overflow>(&destination[0], &source[0], 150, offending)));
+}
+} // namespace anonymous
@@ -0,0 +1,153 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <system_error>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_parallel.hpp"
+
+#if defined(__linux__)
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::parallel_verified_sum;
+using boost::prefix_summary;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::verified_int64_t;
+
+std::size_t const element_count = 300007;
+unsigned int const thread_counts[] = { 1, 2, 3, 4, 8 };
+
+// Random values of both signs within a magnitude of 2^bits.
+template <typename T>
+std::vector<T> summed_values(unsigned int const bits)
+{
+    std::vector<T> values(element_count);
+    uint64_t state = 12345U;
+    for (std::size_t index = 0; index < element_count; ++index) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        values[index] = static_cast<T>(static_cast<int64_t>(state) >> (64 - bits));
+    }
+    return values;
+}
+
+template <typename T, class P>
+T sequential_sum(std::vector<T> const & values)
+{
+    verified_int<T, P> sum;
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        sum += values[index];
+    }
+    return sum;
+}
+
+template <typename T, class P>
+void expect_matches_sequential(std::vector<T> const & values)
+{
+    T const expected = sequential_sum<T, P>(values);
+    for (std::size_t index = 0; index < sizeof(thread_counts) / sizeof(thread_counts[0]); ++index) {
+        EXPECT_EQ(expected, T(parallel_verified_sum<P>(&values[0], values.size(), thread_counts[index])))
+            << thread_counts[index] << " threads";
+    }
+}
+
+TEST(verified_intParallel_TDD, PrefixSummaryMerges) {
+    int64_t const values[] = { 5, -9, 3, 7, -2, -8, 4 };
+    for (std::size_t split = 0; split <= 7; ++split) {
+        prefix_summary<int64_t> whole;
+        prefix_summary<int64_t> first;
+        prefix_summary<int64_t> second;
+        for (std::size_t index = 0; index < 7; ++index) {
+            whole.append(values[index]);
+            (index < split ? first : second).append(values[index]);
+        }
+        first.append(second);
+        EXPECT_EQ(whole.sum, first.sum);
+        EXPECT_EQ(whole.lowest, first.lowest);
+        EXPECT_EQ(whole.highest, first.highest);
+    }
+}
+
+TEST(verified_intParallel_TDD, MatchesSequentialAccumulation) {
+    expect_matches_sequential<int16_t, saturate_overflow>(summed_values<int16_t>(10));
+    expect_matches_sequential<int16_t, saturate_overflow>(summed_values<int16_t>(14));
+    expect_matches_sequential<int16_t, ignore_overflow>(summed_values<int16_t>(14));
+    expect_matches_sequential<int32_t, saturate_overflow>(summed_values<int32_t>(20));
+    expect_matches_sequential<uint32_t, saturate_overflow>(summed_values<uint32_t>(20));
+    expect_matches_sequential<int64_t, saturate_overflow>(summed_values<int64_t>(40));
+    expect_matches_sequential<int64_t, saturate_overflow>(summed_values<int64_t>(62));
+    expect_matches_sequential<int64_t, ignore_overflow>(summed_values<int64_t>(63));
+    expect_matches_sequential<uint64_t, saturate_overflow>(summed_values<uint64_t>(50));
+    expect_matches_sequential<uint64_t, saturate_overflow>(summed_values<uint64_t>(64));
+}
+
+TEST(verified_intParallel_TDD, OverflowInOneChunk) {
+    std::vector<int64_t> values(element_count, 1);
+    values[element_count / 2] = integer_traits<int64_t>::const_max - 10;
+    // The chunk which overflows would be in range on its own.
+    EXPECT_THROW(parallel_verified_sum<throw_overflow>(&values[0], values.size(), 4),
+                 boost::positive_overflow_detected);
+    values[element_count / 2 + 1] = integer_traits<int64_t>::const_min;
+    // An intermediate result overflows, although the total is in range.
+    EXPECT_THROW(parallel_verified_sum<throw_overflow>(&values[0], values.size(), 4),
+                 boost::positive_overflow_detected);
+    expect_matches_sequential<int64_t, saturate_overflow>(values);
+
+    values[element_count / 2] = integer_traits<int64_t>::const_max / 2;
+    EXPECT_NO_THROW(parallel_verified_sum<throw_overflow>(&values[0], values.size(), 4));
+}
+
+TEST(verified_intParallel_TDD, VerifiedIntElements) {
+    std::vector<verified_int64_t> charges(element_count, verified_int64_t(3));
+    EXPECT_EQ(int64_t(3 * element_count), parallel_verified_sum(&charges[0], charges.size(), 4));
+    EXPECT_EQ(0, parallel_verified_sum(&charges[0], 0));
+    EXPECT_EQ(6, parallel_verified_sum(&charges[0], 2, 8));
+}
+
+// Limiting the address space is not compatible with the shadow memory of AddressSanitizer.
+#if defined(__linux__) && !defined(__SANITIZE_ADDRESS__)
+// Limits the address space to what is in use, with room for a few thread stacks but not for
+// 64, and sums with 64 threads.  Exits with 2 when starting a thread throws.
+void sum_without_room_for_threads()
+{
+    std::vector<int32_t> const values(element_count * 64, 1);
+    unsigned long pages = 0;
+    std::FILE *const statm = std::fopen("/proc/self/statm", "r");
+    if (statm == 0 || std::fscanf(statm, "%lu", &pages) != 1) {
+        std::exit(1);
+    }
+    std::fclose(statm);
+    rlimit limit;
+    ::getrlimit(RLIMIT_AS, &limit);
+    limit.rlim_cur = pages * ::sysconf(_SC_PAGESIZE) + (rlim_t(64) << 20);
+    ::setrlimit(RLIMIT_AS, &limit);
+    try {
+        parallel_verified_sum<throw_overflow>(&values[0], values.size(), 64);
+    } catch (std::system_error const &) {
+        std::exit(2);
+    }
+    std::exit(0);
+}
+
+// The workers already started are joined, rather than destroyed joinable, which would
+// terminate.
+TEST(verified_intParallel_TDD, JoinsWhenStartingFails) {
+    EXPECT_EXIT(sum_without_room_for_threads(), ::testing::ExitedWithCode(2), "");
+}
+#endif
+} // namespace anonymous
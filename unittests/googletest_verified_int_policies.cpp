@@ -17,6 +17,8 @@ using boost::integer_traits;
 using boost::saturate_int;
 using boost::verified_int;
 using boost::saturate_overflow;
+using boost::sticky_int;
+using boost::sticky_overflow;
 
 TEST(verified_int_TDD, Conversion) {
     typedef verified_int<uint8_t, saturate_overflow> conversion;
@@ -127,4 +129,51 @@ TEST(BoundingPolicies_TDD, SaturateSubtraction) {
     test -= 10U;
     EXPECT_EQ(0U, test) << ::test_system::toStdString(test);
 }
+TEST(BoundingPolicies_TDD, StickyAccumulate) {
+    sticky_overflow::clear();
+    sticky_int<uint8_t>::type total(0U);
+    for (int i = 0; i < 10; ++i) {
+        total += 20U;
+    }
+    EXPECT_EQ(200U, total) << ::test_system::toStdString(total);
+    EXPECT_FALSE(sticky_overflow::overflowed());
+
+    total += 100U;
+    EXPECT_TRUE(sticky_overflow::overflowed());
+    EXPECT_EQ(static_cast<unsigned int>(boost::e_positive_overflow_detected), sticky_overflow::status());
+    // The value wraps and later operations keep the flag set.
+    EXPECT_EQ(44U, total) << ::test_system::toStdString(total);
+    total -= 4U;
+    EXPECT_TRUE(sticky_overflow::overflowed());
+
+    sticky_overflow::clear();
+    EXPECT_FALSE(sticky_overflow::overflowed());
+    EXPECT_EQ(0U, sticky_overflow::status());
+}
+
+TEST(BoundingPolicies_TDD, StickyBothDirections) {
+    sticky_overflow::clear();
+    sticky_int<int8_t>::type value(integer_traits<int8_t>::const_min);
+    value -= 1;
+    value = integer_traits<int8_t>::const_max;
+    value *= 2;
+    EXPECT_EQ(static_cast<unsigned int>(boost::e_positive_overflow_detected | boost::e_negative_overflow_detected),
+              sticky_overflow::status());
+
+    sticky_overflow::clear();
+    sticky_int<uint16_t>::type converted(-1);
+    EXPECT_EQ(static_cast<unsigned int>(boost::e_negative_overflow_detected), sticky_overflow::status());
+    sticky_overflow::clear();
+}
+
+TEST(BoundingPolicies_TDD, StickyBinaryOperators) {
+    sticky_overflow::clear();
+    sticky_int<uint32_t>::type const valueA(integer_traits<uint32_t>::const_max);
+    sticky_int<uint32_t>::type const valueB(1U);
+    sticky_int<uint32_t>::type const sum = valueA + valueB;
+    EXPECT_EQ(0U, sum) << ::test_system::toStdString(sum);
+    EXPECT_TRUE(sticky_overflow::overflowed());
+    EXPECT_EQ(sizeof(uint32_t), sizeof(sum));
+    sticky_overflow::clear();
+}
 } // namespace anonymous
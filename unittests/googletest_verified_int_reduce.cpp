@@ -0,0 +1,162 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_reduce.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_sum;
+using boost::verified_product;
+using boost::verified_dot;
+using boost::verified_sum_of_squares;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::sticky_overflow;
+using boost::verified_int8_t;
+using boost::verified_int64_t;
+
+// count values of T, each within a magnitude of 2^bits.
+template <typename T>
+std::vector<T> reduction_values(std::size_t const count, unsigned int const bits, unsigned int const seed)
+{
+    std::vector<T> values;
+    for (std::size_t index = 0; index < count; ++index) {
+        uint64_t mixed = (index + seed + 1) * 0x9E3779B97F4A7C15ULL;
+        mixed ^= mixed >> 29;
+        T value = static_cast<T>(mixed & ((uint64_t(1) << bits) - 1));
+        if (integer_traits<T>::is_signed && (mixed >> 63) != 0) {
+            value = static_cast<T>(-value);
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Sequential accumulation, which the reductions must reproduce.
+template <typename T, class P>
+verified_int<T, P> sequential_sum(std::vector<T> const & values)
+{
+    verified_int<T, P> sum;
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        sum += values[index];
+    }
+    return sum;
+}
+
+template <typename T, class P>
+verified_int<T, P> sequential_product(std::vector<T> const & values)
+{
+    verified_int<T, P> product(T(1));
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        product *= values[index];
+    }
+    return product;
+}
+
+template <typename T, class P>
+verified_int<T, P> sequential_dot(std::vector<T> const & left, std::vector<T> const & right)
+{
+    verified_int<T, P> dot;
+    for (std::size_t index = 0; index < left.size(); ++index) {
+        verified_int<T, P> product(left[index]);
+        product *= right[index];
+        dot += T(product);
+    }
+    return dot;
+}
+
+template <typename T, class P>
+void expect_reductions_match(std::vector<T> const & left, std::vector<T> const & right)
+{
+    EXPECT_EQ(T(sequential_sum<T, P>(left)), T(verified_sum<P>(&left[0], left.size())));
+    EXPECT_EQ(T(sequential_product<T, P>(left)), T(verified_product<P>(&left[0], left.size())));
+    EXPECT_EQ(T(sequential_dot<T, P>(left, right)), T(verified_dot<P>(&left[0], &right[0], left.size())));
+    EXPECT_EQ(T(sequential_dot<T, P>(left, left)), T(verified_sum_of_squares<P>(&left[0], left.size())));
+}
+
+// Throws exactly when sequential accumulation throws.
+template <typename T>
+void expect_throws_match(std::vector<T> const & left, std::vector<T> const & right)
+{
+    bool sequential_throws = false;
+    try { sequential_sum<T, throw_overflow>(left); } catch (boost::overflow_detected const &) { sequential_throws = true; }
+    bool reduction_throws = false;
+    try { verified_sum<throw_overflow>(&left[0], left.size()); } catch (boost::overflow_detected const &) { reduction_throws = true; }
+    EXPECT_EQ(sequential_throws, reduction_throws);
+
+    sequential_throws = false;
+    try { sequential_dot<T, throw_overflow>(left, right); } catch (boost::overflow_detected const &) { sequential_throws = true; }
+    reduction_throws = false;
+    try { verified_dot<throw_overflow>(&left[0], &right[0], left.size()); } catch (boost::overflow_detected const &) { reduction_throws = true; }
+    EXPECT_EQ(sequential_throws, reduction_throws);
+}
+
+template <typename T>
+void expect_all_reductions_match()
+{
+    std::size_t const counts[] = { 1, 2, 255, 256, 257, 1000 };
+    unsigned int const bits = sizeof(T) * 8 - 1;
+    unsigned int const magnitudes[] = { 1, bits / 4, bits / 2, bits - 4, bits };
+    for (std::size_t count_index = 0; count_index < sizeof(counts) / sizeof(counts[0]); ++count_index) {
+        for (std::size_t magnitude = 0; magnitude < sizeof(magnitudes) / sizeof(magnitudes[0]); ++magnitude) {
+            std::vector<T> const left = reduction_values<T>(counts[count_index], magnitudes[magnitude], 0);
+            std::vector<T> const right = reduction_values<T>(counts[count_index], magnitudes[magnitude], 7);
+            expect_reductions_match<T, saturate_overflow>(left, right);
+            expect_reductions_match<T, ignore_overflow>(left, right);
+            expect_throws_match<T>(left, right);
+        }
+    }
+}
+
+TEST(verified_intReduce_TDD, MatchesSequentialAccumulation) {
+    expect_all_reductions_match<uint8_t>();
+    expect_all_reductions_match<uint16_t>();
+    expect_all_reductions_match<uint32_t>();
+    expect_all_reductions_match<uint64_t>();
+    expect_all_reductions_match<int8_t>();
+    expect_all_reductions_match<int16_t>();
+    expect_all_reductions_match<int32_t>();
+    expect_all_reductions_match<int64_t>();
+}
+
+TEST(verified_intReduce_TDD, IntermediateOverflow) {
+    int8_t const values[] = { 100, 100, -100 };
+    EXPECT_THROW(verified_sum<throw_overflow>(values, 3), boost::positive_overflow_detected);
+    EXPECT_EQ(27, verified_sum<saturate_overflow>(values, 3));
+    EXPECT_EQ(100, verified_sum<ignore_overflow>(values, 3));
+
+    int8_t const factors[] = { 16, 16, 0 };
+    EXPECT_THROW(verified_product<throw_overflow>(factors, 3), boost::positive_overflow_detected);
+
+    sticky_overflow::clear();
+    EXPECT_EQ(100, verified_sum<sticky_overflow>(values, 3));
+    EXPECT_TRUE(sticky_overflow::overflowed());
+    sticky_overflow::clear();
+}
+
+TEST(verified_intReduce_TDD, VerifiedIntElements) {
+    std::vector<verified_int64_t> prices;
+    for (int64_t price = 1; price <= 100; ++price) {
+        prices.push_back(verified_int64_t(price));
+    }
+    EXPECT_EQ(5050, verified_sum(&prices[0], prices.size()));
+    EXPECT_EQ(338350, verified_sum_of_squares(&prices[0], prices.size()));
+    EXPECT_EQ(5, verified_dot(&prices[0], &prices[0], 2));
+    EXPECT_THROW(verified_product(&prices[0], prices.size()), boost::positive_overflow_detected);
+
+    std::vector<verified_int8_t> const small(3, verified_int8_t(50));
+    EXPECT_THROW(verified_sum(&small[0], small.size()), boost::positive_overflow_detected);
+    EXPECT_EQ(0, verified_sum(&small[0], 0));
+}
+} // namespace anonymous
@@ -0,0 +1,91 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <thread>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_sharded.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::sharded_verified_int;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+
+TEST(verified_intSharded_TDD, SpillsIntoTotal) {
+    sharded_verified_int<uint8_t, throw_overflow> counter;
+    for (unsigned int index = 0; index < 250; ++index) {
+        ++counter;
+    }
+    counter += 5U;
+    EXPECT_EQ(255U, counter.load());
+    // The shard spills into the total, and merging the next increment overflows.
+    ++counter;
+    EXPECT_THROW(counter.load(), boost::positive_overflow_detected);
+    // Spilling the shard again overflows the total, leaving the counter unchanged.
+    counter += 254U;
+    EXPECT_THROW(++counter, boost::positive_overflow_detected);
+    EXPECT_THROW(counter.add(300), boost::positive_overflow_detected);
+
+    // += verifies its operand as a T, as add does.
+    sharded_verified_int<uint8_t, throw_overflow> small;
+    EXPECT_THROW(small += 300, boost::positive_overflow_detected);
+    sharded_verified_int<uint32_t, throw_overflow> unsigned_counter;
+    EXPECT_THROW(unsigned_counter += -1, boost::negative_overflow_detected);
+    unsigned_counter += int64_t(7);
+    EXPECT_EQ(7U, unsigned_counter.load());
+
+    sharded_verified_int<int8_t, saturate_overflow> signed_counter;
+    signed_counter.add(-100);
+    signed_counter.add(-100);
+    EXPECT_EQ(-128, signed_counter.load());
+    // The total saturates when merged, so the counter still holds -200 until then.
+    signed_counter.add(100);
+    EXPECT_EQ(-100, signed_counter.load());
+}
+
+TEST(verified_intSharded_TDD, IgnoreWraps) {
+    sharded_verified_int<uint8_t, ignore_overflow> counter;
+    for (unsigned int index = 0; index < 1000; ++index) {
+        ++counter;
+    }
+    EXPECT_EQ(uint8_t(1000U), counter.load());
+}
+
+// Threads which increment concurrently lose no increments, and overflow of the total is
+// handled whether the shards spill or load merges them.
+TEST(verified_intSharded_TDD, ConcurrentIncrements) {
+    unsigned int const thread_count = 6;
+    unsigned int const increments = 50000;
+    sharded_verified_int<uint64_t, throw_overflow> total;
+    sharded_verified_int<uint16_t, saturate_overflow, 4> saturated;
+    sharded_verified_int<uint16_t, ignore_overflow, 4> wrapped;
+    sharded_verified_int<int32_t, saturate_overflow, 2> small;
+    std::vector<std::thread> threads;
+    for (unsigned int thread = 0; thread < thread_count; ++thread) {
+        threads.push_back(std::thread([&]() {
+            for (unsigned int index = 0; index < increments; ++index) {
+                ++total;
+                ++saturated;
+                ++wrapped;
+                small += 3;
+            }
+        }));
+    }
+    for (unsigned int thread = 0; thread < thread_count; ++thread) {
+        threads[thread].join();
+    }
+    EXPECT_EQ(uint64_t(thread_count) * increments, total.load());
+    EXPECT_EQ(integer_traits<uint16_t>::const_max, saturated.load());
+    EXPECT_EQ(uint16_t(thread_count * increments), wrapped.load());
+    EXPECT_EQ(int32_t(3 * thread_count * increments), small.load());
+}
+} // namespace anonymous
@@ -0,0 +1,213 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int.hpp"
+#include "verified_int_simd.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_simd;
+using boost::saturate_int;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::sticky_overflow;
+
+// Lane values mixing the limits of T with pseudo random values.
+template <typename T>
+T lane_value(unsigned int const index)
+{
+    static T const limits[] = {
+        integer_traits<T>::const_min, integer_traits<T>::const_max, T(0), T(1), T(-1),
+        T(integer_traits<T>::const_max / 2), T(integer_traits<T>::const_min / 2)
+    };
+    if (index % 3 == 0) {
+        return limits[index / 3 % (sizeof(limits) / sizeof(limits[0]))];
+    }
+    uint64_t mixed = (index + 1) * 0x9E3779B97F4A7C15ULL;
+    mixed ^= mixed >> 29;
+    return static_cast<T>(mixed);
+}
+
+// Every lane must match a saturating verified_int, whichever kernel computed it.
+template <typename T, std::size_t N>
+void expect_lanes_match_verified_int()
+{
+    typedef verified_simd<T, N, saturate_overflow> simd_type;
+    typedef verified_int<T, saturate_overflow> scalar_type;
+    for (unsigned int round = 0; round < 64; ++round) {
+        T left[N];
+        T right[N];
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            left[lane] = lane_value<T>(round * 131 + lane);
+            right[lane] = lane_value<T>(round * 71 + lane * 5 + 1);
+        }
+        simd_type const simd_left = simd_type::load(left);
+        simd_type const simd_right = simd_type::load(right);
+        simd_type const sum = simd_left + simd_right;
+        simd_type const difference = simd_left - simd_right;
+        simd_type const product = simd_left * simd_right;
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            scalar_type expected(left[lane]);
+            expected += right[lane];
+            EXPECT_EQ(T(expected), sum[lane]);
+            expected = left[lane];
+            expected -= right[lane];
+            EXPECT_EQ(T(expected), difference[lane]);
+            expected = left[lane];
+            expected *= right[lane];
+            EXPECT_EQ(T(expected), product[lane]);
+        }
+    }
+}
+
+TEST(verified_intSimd_TDD, LanesMatchVerifiedInt) {
+    expect_lanes_match_verified_int<int8_t, 32>();
+    expect_lanes_match_verified_int<uint8_t, 16>();
+    expect_lanes_match_verified_int<int16_t, 16>();
+    expect_lanes_match_verified_int<uint16_t, 8>();
+    expect_lanes_match_verified_int<int32_t, 8>();
+    expect_lanes_match_verified_int<uint32_t, 4>();
+    expect_lanes_match_verified_int<int64_t, 4>();
+    expect_lanes_match_verified_int<uint64_t, 2>();
+    // Lanes which do not fill a register use the scalar loop.
+    expect_lanes_match_verified_int<int16_t, 3>();
+    expect_lanes_match_verified_int<uint32_t, 5>();
+}
+
+TEST(verified_intSimd_TDD, ThrowsIfAnyLaneOverflows) {
+    typedef verified_simd<int32_t, 4, throw_overflow> simd_type;
+    int32_t const values[] = { 1, 2, integer_traits<int32_t>::const_max, 4 };
+    simd_type lanes = simd_type::load(values);
+    EXPECT_NO_THROW(lanes - simd_type(1));
+    EXPECT_THROW(lanes + simd_type(1), boost::positive_overflow_detected);
+    EXPECT_THROW(lanes * simd_type(-2), boost::negative_overflow_detected);
+    EXPECT_NO_THROW(lanes += simd_type(0));
+    EXPECT_EQ(integer_traits<int32_t>::const_max, lanes[2]);
+}
+
+TEST(verified_intSimd_TDD, SaturatesOnlyOverflowedLanes) {
+    typedef verified_simd<uint8_t, 16, saturate_overflow> simd_type;
+    uint8_t values[16];
+    for (unsigned int lane = 0; lane < 16; ++lane) {
+        values[lane] = static_cast<uint8_t>(lane * 16);
+    }
+    simd_type const sum = simd_type::load(values) + simd_type(100);
+    simd_type const difference = simd_type::load(values) - simd_type(100);
+    for (unsigned int lane = 0; lane < 16; ++lane) {
+        EXPECT_EQ(lane * 16 + 100 > 255 ? 255U : lane * 16 + 100, sum[lane]);
+        EXPECT_EQ(lane * 16 < 100 ? 0U : lane * 16 - 100, difference[lane]);
+    }
+}
+
+TEST(verified_intSimd_TDD, IgnoreWraps) {
+    typedef verified_simd<int16_t, 8, ignore_overflow> simd_type;
+    simd_type const sum = simd_type(integer_traits<int16_t>::const_max) + simd_type(1);
+    EXPECT_EQ(integer_traits<int16_t>::const_min, sum[7]);
+}
+
+TEST(verified_intSimd_TDD, StickyRecordsEveryLane) {
+    typedef verified_simd<uint16_t, 8, sticky_overflow> simd_type;
+    sticky_overflow::clear();
+    simd_type lanes(1000);
+    lanes *= simd_type(60);
+    EXPECT_FALSE(sticky_overflow::overflowed());
+    lanes *= simd_type(2);
+    EXPECT_TRUE(sticky_overflow::overflowed());
+    EXPECT_EQ(uint16_t(120000U), lanes[0]);
+    sticky_overflow::clear();
+}
+
+TEST(verified_intSimd_TDD, Conversion) {
+    typedef verified_simd<int8_t, 4, saturate_overflow> narrow_type;
+    typedef verified_simd<int32_t, 4, throw_overflow> wide_type;
+    int32_t const values[] = { -200, -128, 127, 200 };
+    narrow_type const narrowed = narrow_type::load(values);
+    EXPECT_EQ(-128, narrowed[0]);
+    EXPECT_EQ(-128, narrowed[1]);
+    EXPECT_EQ(127, narrowed[2]);
+    EXPECT_EQ(127, narrowed[3]);
+
+    wide_type const widened(narrowed);
+    EXPECT_EQ(-128, widened[0]);
+    typedef verified_simd<uint8_t, 4, throw_overflow> unsigned_type;
+    EXPECT_THROW(unsigned_type converted(widened), boost::negative_overflow_detected);
+}
+// Every element, including the tail after the last whole register, must match
+// saturate_int<T>::type.
+template <typename T>
+void expect_buffers_match_saturate_int(std::vector<T> const & left, std::vector<T> const & right)
+{
+    std::size_t const counts[] = { 0, 1, 15, 16, 17, 31, 33, 63, left.size() };
+    for (std::size_t count_index = 0; count_index < sizeof(counts) / sizeof(counts[0]); ++count_index) {
+        std::size_t const count = counts[count_index];
+        std::vector<T> sums(count + 1, T(7));
+        std::vector<T> differences(count + 1, T(7));
+        boost::saturate_add(&sums[0], &left[0], &right[0], count);
+        boost::saturate_sub(&differences[0], &left[0], &right[0], count);
+        for (std::size_t index = 0; index < count; ++index) {
+            typename saturate_int<T>::type expected(left[index]);
+            expected += right[index];
+            ASSERT_EQ(T(expected), sums[index]) << index;
+            expected = left[index];
+            expected -= right[index];
+            ASSERT_EQ(T(expected), differences[index]) << index;
+        }
+        EXPECT_EQ(T(7), sums[count]);
+        EXPECT_EQ(T(7), differences[count]);
+    }
+}
+
+// Every pair of 8-bit values.
+template <typename T>
+void expect_every_pair_matches_saturate_int()
+{
+    std::vector<T> left;
+    std::vector<T> right;
+    for (unsigned int first = 0; first < 256; ++first) {
+        for (unsigned int second = 0; second < 256; ++second) {
+            left.push_back(static_cast<T>(first));
+            right.push_back(static_cast<T>(second));
+        }
+    }
+    expect_buffers_match_saturate_int(left, right);
+}
+
+template <typename T>
+void expect_mixed_values_match_saturate_int()
+{
+    std::vector<T> left;
+    std::vector<T> right;
+    for (unsigned int index = 0; index < 4099; ++index) {
+        left.push_back(lane_value<T>(index));
+        right.push_back(lane_value<T>(index * 7 + 2));
+    }
+    expect_buffers_match_saturate_int(left, right);
+}
+
+TEST(verified_intSimd_TDD, SaturateBuffers) {
+    expect_every_pair_matches_saturate_int<int8_t>();
+    expect_every_pair_matches_saturate_int<uint8_t>();
+    expect_mixed_values_match_saturate_int<int16_t>();
+    expect_mixed_values_match_saturate_int<uint16_t>();
+}
+
+TEST(verified_intSimd_TDD, SaturateBuffersInPlace) {
+    std::vector<uint8_t> mixed(40, 200);
+    std::vector<uint8_t> const gain(40, 100);
+    boost::saturate_add(&mixed[0], &mixed[0], &gain[0], mixed.size());
+    EXPECT_EQ(std::vector<uint8_t>(40, 255), mixed);
+    boost::saturate_sub(&mixed[0], &gain[0], &mixed[0], mixed.size());
+    EXPECT_EQ(std::vector<uint8_t>(40, 0), mixed);
+}
+} // namespace anonymous
@@ -9,6 +9,7 @@
 #include <testsystem.hpp>
 #include <stringutils.hpp>
 #include <climits>
+#include <boost/integer_traits.hpp>
 #include "verified_int.hpp"
 
 namespace {
@@ -599,4 +600,79 @@ TEST(verified_intDivision_TDD, UnSignedMinSubtractOne) {
         lhs -= rhs;
     }));
 }
+
+template <typename L, typename R>
+void expect_exact_subtraction() {
+    typedef boost::do_detect_overflow<L, R> detection_type;
+    for (int32_t left = boost::integer_traits<L>::const_min; left <= boost::integer_traits<L>::const_max; ++left) {
+        for (int32_t right = boost::integer_traits<R>::const_min; right <= boost::integer_traits<R>::const_max; ++right) {
+            int32_t const exact = left - right;
+            boost::overflow_result expected = boost::e_no_overflow_detected;
+            if (exact > boost::integer_traits<L>::const_max) {
+                expected = boost::e_positive_overflow_detected;
+            } else if (exact < boost::integer_traits<L>::const_min) {
+                expected = boost::e_negative_overflow_detected;
+            }
+            ASSERT_EQ(expected, detection_type::detect_overflow_subtraction(
+                static_cast<L>(left), static_cast<R>(right))) << left << " - " << right;
+        }
+    }
+}
+
+TEST(verified_intSubtraction_TDD, ExactDetection8Bit) {
+    expect_exact_subtraction<uint8_t, uint8_t>();
+    expect_exact_subtraction<uint8_t, int8_t>();
+    expect_exact_subtraction<int8_t, uint8_t>();
+    expect_exact_subtraction<int8_t, int8_t>();
+}
+
+TEST(verified_intSubtraction_TDD, ExactDetection16Bit) {
+    expect_exact_subtraction<uint16_t, int8_t>();
+    expect_exact_subtraction<int16_t, uint8_t>();
+    expect_exact_subtraction<uint8_t, int16_t>();
+    expect_exact_subtraction<int8_t, uint16_t>();
+}
+
+// 32-bit operands are too wide to check exhaustively, so each operand takes the values
+// near its limits and near zero.
+template <typename L, typename R>
+void expect_exact_subtraction_near_limits() {
+    typedef boost::do_detect_overflow<L, R> detection_type;
+    int64_t const left_min = boost::integer_traits<L>::const_min;
+    int64_t const left_max = boost::integer_traits<L>::const_max;
+    int64_t const right_min = boost::integer_traits<R>::const_min;
+    int64_t const right_max = boost::integer_traits<R>::const_max;
+    int64_t const lefts[] = { left_min, left_min + 1, left_min + 2, -5, -3, -1, 0, 1, 3, 5,
+                              left_max - 2, left_max - 1, left_max };
+    int64_t const rights[] = { right_min, right_min + 1, right_min + 2, -5, -3, -1, 0, 1, 3, 5,
+                               right_max - 2, right_max - 1, right_max };
+    for (std::size_t i = 0; i < sizeof(lefts) / sizeof(lefts[0]); ++i) {
+        for (std::size_t j = 0; j < sizeof(rights) / sizeof(rights[0]); ++j) {
+            int64_t const left = lefts[i];
+            int64_t const right = rights[j];
+            if (left < left_min || left > left_max || right < right_min || right > right_max) {
+                continue;
+            }
+            int64_t const exact = left - right;
+            boost::overflow_result expected = boost::e_no_overflow_detected;
+            if (exact > left_max) {
+                expected = boost::e_positive_overflow_detected;
+            } else if (exact < left_min) {
+                expected = boost::e_negative_overflow_detected;
+            }
+            ASSERT_EQ(expected, detection_type::detect_overflow_subtraction(
+                static_cast<L>(left), static_cast<R>(right))) << left << " - " << right;
+        }
+    }
+}
+
+TEST(verified_intSubtraction_TDD, ExactDetection32Bit) {
+    expect_exact_subtraction_near_limits<int32_t, int32_t>();
+    expect_exact_subtraction_near_limits<int32_t, uint32_t>();
+
+    verified_int<int32_t, throw_overflow> value(5);
+    EXPECT_NO_THROW(value -= int32_t(-3));
+    EXPECT_NO_THROW(value -= int32_t(3));
+    EXPECT_EQ(5, value);
+}
 } // namespace anonymous
@@ -0,0 +1,296 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_METAASSERT_UNITTEST defined
+
+#include <testsystem.hpp>
+#include <stringutils.hpp>
+#include <vector>
+#include <boost/integer_traits.hpp>
+#include "verified_int_varint.hpp"
+
+namespace {
+
+using boost::integer_traits;
+using boost::verified_int;
+using boost::verified_decode_result;
+using boost::verified_encode_result;
+using boost::verified_packed_decode_result;
+using boost::encode_varint;
+using boost::encode_zigzag;
+using boost::decode_varint;
+using boost::decode_zigzag;
+using boost::decode_packed_varints;
+using boost::decode_packed_zigzags;
+using boost::max_varint_size;
+using boost::saturate_overflow;
+using boost::ignore_overflow;
+using boost::throw_overflow;
+using boost::e_no_overflow_detected;
+using boost::e_positive_overflow_detected;
+using boost::e_negative_overflow_detected;
+using boost::verified_int32_t;
+using boost::verified_uint32_t;
+using boost::verified_uint64_t;
+
+// Powers of two of T, their neighbours, and the limits of T.
+template <typename T>
+std::vector<T> samples()
+{
+    std::vector<T> values;
+    for (unsigned int shift = 0; shift < sizeof(T) * 8; ++shift) {
+        uint64_t const power = uint64_t(1) << shift;
+        values.push_back(static_cast<T>(power));
+        values.push_back(static_cast<T>(power - 1));
+        values.push_back(static_cast<T>(0 - power));
+        values.push_back(static_cast<T>(power * 5 / 3));
+    }
+    values.push_back(integer_traits<T>::const_max);
+    values.push_back(integer_traits<T>::const_min);
+    return values;
+}
+
+template <typename T>
+void expect_varints_round_trip()
+{
+    std::vector<T> const values = samples<T>();
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        verified_int<T, throw_overflow> const value(values[index]);
+        uint8_t buffer[max_varint_size];
+        verified_encode_result const encoded = encode_varint(buffer, buffer + sizeof(buffer), value);
+        ASSERT_TRUE(encoded.fits);
+        verified_int<T, throw_overflow> decoded;
+        verified_decode_result const result = decode_varint(buffer, encoded.ptr, decoded);
+        EXPECT_EQ(encoded.ptr, result.ptr);
+        EXPECT_EQ(e_no_overflow_detected, result.result);
+        EXPECT_EQ(T(value), T(decoded));
+
+        // Too small by one byte.
+        std::ptrdiff_t const length = encoded.ptr - buffer;
+        verified_encode_result const too_long = encode_varint(buffer, buffer + length - 1, value);
+        EXPECT_FALSE(too_long.fits);
+        EXPECT_EQ(buffer + length - 1, too_long.ptr);
+        // Missing the last byte.
+        EXPECT_EQ(buffer, decode_varint(buffer, buffer + length - 1, decoded).ptr);
+        EXPECT_EQ(T(value), T(decoded));
+    }
+}
+
+template <typename T>
+void expect_zigzags_round_trip()
+{
+    std::vector<T> const values = samples<T>();
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        verified_int<T, throw_overflow> const value(values[index]);
+        uint8_t buffer[max_varint_size];
+        verified_encode_result const encoded = encode_zigzag(buffer, buffer + sizeof(buffer), value);
+        ASSERT_TRUE(encoded.fits);
+        verified_int<T, throw_overflow> decoded;
+        EXPECT_EQ(encoded.ptr, decode_zigzag(buffer, encoded.ptr, decoded).ptr);
+        EXPECT_EQ(T(value), T(decoded));
+    }
+}
+
+TEST(verified_intVarint_TDD, RoundTrips) {
+    expect_varints_round_trip<uint8_t>();
+    expect_varints_round_trip<uint16_t>();
+    expect_varints_round_trip<uint32_t>();
+    expect_varints_round_trip<uint64_t>();
+    expect_varints_round_trip<int8_t>();
+    expect_varints_round_trip<int16_t>();
+    expect_varints_round_trip<int32_t>();
+    expect_varints_round_trip<int64_t>();
+    expect_zigzags_round_trip<int8_t>();
+    expect_zigzags_round_trip<int16_t>();
+    expect_zigzags_round_trip<int32_t>();
+    expect_zigzags_round_trip<int64_t>();
+}
+
+TEST(verified_intVarint_TDD, MatchesProtocolBuffers) {
+    uint8_t buffer[max_varint_size];
+    verified_encode_result encoded = encode_varint(buffer, buffer + sizeof(buffer), verified_uint32_t(300U));
+    ASSERT_EQ(buffer + 2, encoded.ptr);
+    EXPECT_EQ(0xAC, buffer[0]);
+    EXPECT_EQ(0x02, buffer[1]);
+
+    // Negative numbers are sign-extended to ten bytes, unless zigzag encoded.
+    encoded = encode_varint(buffer, buffer + sizeof(buffer), verified_int32_t(-1));
+    ASSERT_EQ(buffer + 10, encoded.ptr);
+    EXPECT_EQ(0xFF, buffer[0]);
+    EXPECT_EQ(0x01, buffer[9]);
+    encoded = encode_zigzag(buffer, buffer + sizeof(buffer), verified_int32_t(-1));
+    ASSERT_EQ(buffer + 1, encoded.ptr);
+    EXPECT_EQ(0x01, buffer[0]);
+    encoded = encode_zigzag(buffer, buffer + sizeof(buffer), verified_int32_t(1));
+    EXPECT_EQ(0x02, buffer[0]);
+    encoded = encode_zigzag(buffer, buffer + sizeof(buffer), verified_int32_t(integer_traits<int32_t>::const_min));
+    ASSERT_EQ(buffer + 5, encoded.ptr);
+    EXPECT_EQ(0x0F, buffer[4]);
+}
+
+TEST(verified_intVarint_TDD, DetectsOverflow) {
+    // 2^64 - 1, which a uint32 field would truncate.
+    uint8_t const malicious[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    uint8_t const *const end = malicious + sizeof(malicious);
+    verified_uint32_t thrown(7U);
+    EXPECT_THROW(decode_varint(malicious, end, thrown), boost::positive_overflow_detected);
+    EXPECT_EQ(7U, thrown);
+
+    verified_int<uint32_t, saturate_overflow> saturated;
+    verified_decode_result const result = decode_varint(malicious, end, saturated);
+    EXPECT_EQ(end, result.ptr);
+    EXPECT_EQ(e_positive_overflow_detected, result.result);
+    EXPECT_EQ(integer_traits<uint32_t>::const_max, saturated);
+
+    verified_int<uint32_t, ignore_overflow> wrapped;
+    EXPECT_EQ(e_no_overflow_detected, decode_varint(malicious, end, wrapped).result);
+    EXPECT_EQ(integer_traits<uint32_t>::const_max, wrapped);
+
+    // -1 fits a signed field, but not a zigzag field of 8 bits.
+    verified_int32_t negative;
+    decode_varint(malicious, end, negative);
+    EXPECT_EQ(-1, negative);
+    uint8_t const large[] = { 0x81, 0x02 };
+    verified_int<int8_t, saturate_overflow> small;
+    EXPECT_EQ(e_negative_overflow_detected, decode_zigzag(large, large + 2, small).result);
+    EXPECT_EQ(-128, small);
+}
+
+TEST(verified_intVarint_TDD, DetectsOverlongEncodings) {
+    // Zero, in eleven bytes.
+    uint8_t const eleven[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+    verified_uint64_t value;
+    EXPECT_THROW(decode_varint(eleven, eleven + sizeof(eleven), value), boost::positive_overflow_detected);
+    verified_int<uint64_t, saturate_overflow> saturated;
+    verified_decode_result const result = decode_varint(eleven, eleven + sizeof(eleven), saturated);
+    EXPECT_EQ(eleven + sizeof(eleven), result.ptr);
+    EXPECT_EQ(e_positive_overflow_detected, result.result);
+    EXPECT_EQ(integer_traits<uint64_t>::const_max, saturated);
+
+    // 65 bits in ten bytes.
+    uint8_t const wide[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02 };
+    EXPECT_THROW(decode_varint(wide, wide + sizeof(wide), value), boost::positive_overflow_detected);
+    // 64 bits in ten bytes, and zero with redundant bytes, are not.
+    uint8_t const highest[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+    decode_varint(highest, highest + sizeof(highest), value);
+    EXPECT_EQ(uint64_t(1) << 63, value);
+    decode_varint(eleven + 1, eleven + sizeof(eleven), value);
+    EXPECT_EQ(0U, value);
+
+    verified_int<uint64_t, ignore_overflow> wrapped;
+    EXPECT_EQ(e_no_overflow_detected, decode_varint(eleven, eleven + sizeof(eleven), wrapped).result);
+    EXPECT_EQ(0U, wrapped);
+}
+
+// Varints of every length, some over-long, some out of the range of a uint16_t or int16_t.
+std::vector<uint8_t> packed_varints(std::size_t const count)
+{
+    std::vector<uint8_t> bytes;
+    uint64_t mixed = 0x9E3779B97F4A7C15ULL;
+    for (std::size_t index = 0; index < count; ++index) {
+        mixed = mixed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::size_t const kind = (mixed >> 59) % 8;
+        if (kind < 4) {
+            bytes.push_back(static_cast<uint8_t>((mixed >> 40) & 0x7F));
+        } else if (kind == 4) {
+            bytes.insert(bytes.end(), 9 + (mixed >> 40) % 12, 0x80);
+            bytes.push_back(0x00);
+        } else {
+            uint64_t bits = mixed >> ((mixed >> 20) % 64);
+            while (bits >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(bits | 0x80));
+                bits >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(bits));
+        }
+    }
+    return bytes;
+}
+
+// Decodes with decode_varint, or decode_zigzag, one at a time.
+struct varints
+{
+    template <class Integer>
+    static uint8_t const *decode(uint8_t const *first, uint8_t const *last, Integer &value)
+    {
+        return decode_varint(first, last, value).ptr;
+    }
+
+    template <class Integer>
+    static verified_packed_decode_result decode_packed(uint8_t const *first, uint8_t const *last,
+                                                       Integer *destination, std::size_t capacity)
+    {
+        return decode_packed_varints(first, last, destination, capacity);
+    }
+};
+
+struct zigzags
+{
+    template <class Integer>
+    static uint8_t const *decode(uint8_t const *first, uint8_t const *last, Integer &value)
+    {
+        return decode_zigzag(first, last, value).ptr;
+    }
+
+    template <class Integer>
+    static verified_packed_decode_result decode_packed(uint8_t const *first, uint8_t const *last,
+                                                       Integer *destination, std::size_t capacity)
+    {
+        return decode_packed_zigzags(first, last, destination, capacity);
+    }
+};
+
+template <class Encoding, class Integer>
+void expect_packed_matches_scalar(std::vector<uint8_t> const &bytes, std::size_t const capacity)
+{
+    uint8_t const *const first = bytes.empty() ? 0 : &bytes[0];
+    uint8_t const *const last = first + bytes.size();
+    std::vector<Integer> expected;
+    uint8_t const *position = first;
+    while (expected.size() < capacity) {
+        Integer value;
+        uint8_t const *const end = Encoding::decode(position, last, value);
+        if (end == position) {
+            break;
+        }
+        expected.push_back(value);
+        position = end;
+    }
+
+    std::vector<Integer> decoded(capacity + 1);
+    verified_packed_decode_result const result = Encoding::decode_packed(first, last, &decoded[0], capacity);
+    EXPECT_EQ(position, result.ptr);
+    ASSERT_EQ(expected.size(), result.count);
+    for (std::size_t index = 0; index < expected.size(); ++index) {
+        EXPECT_EQ(expected[index], decoded[index]) << index;
+    }
+}
+
+TEST(verified_intVarint_TDD, PackedMatchesScalar) {
+    std::vector<uint8_t> bytes = packed_varints(5000);
+    expect_packed_matches_scalar<varints, verified_int<uint16_t, saturate_overflow> >(bytes, 5000);
+    expect_packed_matches_scalar<varints, verified_int<uint64_t, saturate_overflow> >(bytes, 5000);
+    expect_packed_matches_scalar<zigzags, verified_int<int16_t, saturate_overflow> >(bytes, 5000);
+    expect_packed_matches_scalar<varints, verified_int<uint32_t, ignore_overflow> >(bytes, 5000);
+    expect_packed_matches_scalar<zigzags, verified_int<int64_t, ignore_overflow> >(bytes, 5000);
+    // Stopping at capacity.
+    expect_packed_matches_scalar<varints, verified_int<uint16_t, saturate_overflow> >(bytes, 1234);
+    // Stopping at a truncated varint.
+    bytes.push_back(0x80);
+    expect_packed_matches_scalar<varints, verified_int<uint64_t, saturate_overflow> >(bytes, 6000);
+    expect_packed_matches_scalar<varints, verified_int<uint64_t, saturate_overflow> >(std::vector<uint8_t>(), 10);
+
+    // One-byte varints, sixteen at a time.
+    std::vector<uint8_t> small(100);
+    for (std::size_t index = 0; index < small.size(); ++index) {
+        small[index] = static_cast<uint8_t>(index);
+    }
+    expect_packed_matches_scalar<zigzags, verified_int<int8_t, saturate_overflow> >(small, 100);
+
+    std::vector<verified_int<uint16_t, throw_overflow> > thrown(5000);
+    EXPECT_THROW(decode_packed_varints(&bytes[0], &bytes[0] + bytes.size(), &thrown[0], thrown.size()),
+                 boost::positive_overflow_detected);
+}
+} // namespace anonymous
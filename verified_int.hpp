@@ -7,8 +7,11 @@
 #ifndef VERIFIED_INT_HPP
 #define VERIFIED_INT_HPP
 
+#include <cstddef>
+#include <boost/config.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/type_traits/common_type.hpp>
+#include "verified_int_checked.hpp"
 #include "verified_int_policies.hpp"
 #include "verified_int_overflow_detection.hpp"
 
@@ -19,21 +22,22 @@ class verified_int
 {
 public:
     // Default constructor.
-    verified_int() : value_(0)
+    BOOST_CONSTEXPR verified_int() : value_(0)
     {
     }
 
     // Copy constructor (to avoid re-verifying for overflow).
-    verified_int(verified_int const & verified) :
+    BOOST_CONSTEXPR verified_int(verified_int const & verified) :
         value_(verified.value_)
     {
     }
     // Conversion constructors
     #define GEN_CONVERSION_CONSTRUCTOR(TYPE) \
-    explicit verified_int(TYPE const value) : value_(value) \
+    explicit BOOST_CXX14_CONSTEXPR verified_int(TYPE const value) : value_(value) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_assignment(value); \
+        P::template record_overflow<T, TYPE>(e_assignment_operation, detected); \
         value_ = P::handle_overflow(value_, detected); \
     }
     GEN_CONVERSION_CONSTRUCTOR(uint8_t)
@@ -47,17 +51,18 @@ public:
     #undef GEN_CONVERSION_CONSTRUCTOR
 
     // Copy assignment operator
-    verified_int& operator=(verified_int const verified)
+    BOOST_CXX14_CONSTEXPR verified_int& operator=(verified_int const verified)
     {
         value_ = verified.value_;
         return *this;
     }
     // Conversion assignment operators
     #define GEN_CONVERSION_ASSIGNMENT(TYPE) \
-    verified_int& operator=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator=(TYPE const right) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_assignment(right); \
+        P::template record_overflow<T, TYPE>(e_assignment_operation, detected); \
         value_ = P::handle_overflow(right, detected); \
         return *this; \
     }
@@ -72,20 +77,20 @@ public:
     #undef GEN_CONVERSION_ASSIGNMENT
 
     // Conversion back to a builtin type
-    operator T() const
+    BOOST_CONSTEXPR operator T() const
     {
         return value_;
     }
 
     // Prefix increment operator.
-    verified_int & operator++()
+    BOOST_CXX14_CONSTEXPR verified_int & operator++()
     {
         *this += 1;
         return *this;
     }
 
     // Postfix increment operator.
-    verified_int const operator++(int postfix_signature)
+    BOOST_CXX14_CONSTEXPR verified_int const operator++(int postfix_signature)
     {
         (void)postfix_signature;
         verified_int before_increment(*this);
@@ -94,21 +99,21 @@ public:
     }
 
     // Unary addition operator.
-    verified_int const operator+()
+    BOOST_CXX14_CONSTEXPR verified_int const operator+()
     {
         verified_int copied_int(this->value_);
         return copied_int;
     }
 
     // Prefix decrement operator.
-    verified_int & operator--()
+    BOOST_CXX14_CONSTEXPR verified_int & operator--()
     {
         *this -= 1;
         return *this;
     }
 
     // Postfix decrement operator.
-    verified_int const operator--(int postfix_signature)
+    BOOST_CXX14_CONSTEXPR verified_int const operator--(int postfix_signature)
     {
         (void)postfix_signature;
         verified_int before_decrement(*this);
@@ -116,17 +121,18 @@ public:
         return before_decrement;
     }
 
-    verified_int const operator-()
+    BOOST_CXX14_CONSTEXPR verified_int const operator-()
     {
         verified_int negated_int(-this->value_);
         return negated_int;
     }
 
     #define GEN_OPERATOR_PLUS_EQUALS(TYPE) \
-    verified_int& operator+=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator+=(TYPE const right) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_addition(value_, right); \
+        P::template record_overflow<T, TYPE>(e_addition_operation, detected); \
         value_ += right; \
         value_ = P::handle_overflow(value_, detected); \
         return *this; \
@@ -142,10 +148,11 @@ public:
     #undef GEN_OPERATOR_PLUS_EQUALS
 
     #define GEN_OPERATOR_MINUS_EQUALS(TYPE) \
-    verified_int& operator-=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator-=(TYPE const right) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_subtraction(value_, right); \
+        P::template record_overflow<T, TYPE>(e_subtraction_operation, detected); \
         value_ -= right; \
         value_ = P::handle_overflow(value_, detected); \
         return *this; \
@@ -161,10 +168,11 @@ public:
     #undef GEN_OPERATOR_MINUS_EQUALS
 
     #define GEN_OPERATOR_TIMES_EQUALS(TYPE) \
-    verified_int& operator*=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator*=(TYPE const right) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_multiplication(value_, right); \
+        P::template record_overflow<T, TYPE>(e_multiplication_operation, detected); \
         value_ *= right; \
         value_ = P::handle_overflow(value_, detected); \
         return *this; \
@@ -180,10 +188,11 @@ public:
     #undef GEN_OPERATOR_TIMES_EQUALS
 
     #define GEN_OPERATOR_DIVIDE_EQUALS(TYPE) \
-    verified_int& operator/=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator/=(TYPE const right) \
     { \
         typedef typename P::template detection<T, TYPE>::type detection_type; \
         overflow_result detected = detection_type::detect_overflow_division(value_, right); \
+        P::template record_overflow<T, TYPE>(e_division_operation, detected); \
         value_ /= right; \
         value_ = P::handle_overflow(value_, detected); \
         return *this; \
@@ -199,7 +208,7 @@ public:
     #undef GEN_OPERATOR_DIVIDE_EQUALS
 
     #define GEN_OPERATOR_MOD_EQUALS(TYPE) \
-    verified_int& operator%=(TYPE const right) \
+    BOOST_CXX14_CONSTEXPR verified_int& operator%=(TYPE const right) \
     { \
         value_ %= right; \
         return *this; \
@@ -214,6 +223,31 @@ public:
     GEN_OPERATOR_MOD_EQUALS(int64_t)
     #undef GEN_OPERATOR_MOD_EQUALS
 
+    // Non-throwing operations.  Each returns the overflow detected by the policy, and
+    // only updates the value when there is none.  The policy does not handle the overflow.
+    #define GEN_TRY_OPERATION(TRY_NAME, CHECKED_OPERATION, TYPE) \
+    BOOST_CXX14_CONSTEXPR overflow_result TRY_NAME(TYPE const right) \
+    { \
+        checked_result<T> const checked = checked_arithmetic<P>::CHECKED_OPERATION(value_, right); \
+        value_ = checked.result == e_no_overflow_detected ? checked.value : value_; \
+        return checked.result; \
+    }
+    #define GEN_TRY_OPERATIONS(TYPE) \
+    GEN_TRY_OPERATION(try_add, add, TYPE) \
+    GEN_TRY_OPERATION(try_sub, subtract, TYPE) \
+    GEN_TRY_OPERATION(try_mul, multiply, TYPE) \
+    GEN_TRY_OPERATION(try_div, divide, TYPE)
+    GEN_TRY_OPERATIONS(uint8_t)
+    GEN_TRY_OPERATIONS(uint16_t)
+    GEN_TRY_OPERATIONS(uint32_t)
+    GEN_TRY_OPERATIONS(uint64_t)
+    GEN_TRY_OPERATIONS(int8_t)
+    GEN_TRY_OPERATIONS(int16_t)
+    GEN_TRY_OPERATIONS(int32_t)
+    GEN_TRY_OPERATIONS(int64_t)
+    #undef GEN_TRY_OPERATIONS
+    #undef GEN_TRY_OPERATION
+
 private:
     T value_;
 };
@@ -224,7 +258,7 @@ private:
 // Performs math on two verified_ints.  Both must share the same Policy.
 #define GEN_BINARY_OPERATORS_VERIFIED_SAME(OPERATOR_MATH, MATH_ASSIGN) \
     template <typename L, typename R, class P> \
-    verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
+    BOOST_CXX14_CONSTEXPR verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
             verified_int<L, P> const & left, \
             verified_int<R, P> const & right) \
     { \
@@ -242,7 +276,7 @@ GEN_BINARY_OPERATORS_VERIFIED_SAME(operator%, %=)
 // Performs math on one verified_int on the left and a builtin on the right.
 #define GEN_BINARY_OPERATORS_VERIFIED_ON_LEFT(OPERATOR_MATH, MATH_ASSIGN) \
     template <typename L, typename R, class P> \
-    verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
+    BOOST_CXX14_CONSTEXPR verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
             verified_int<L, P> const & left, \
             R const & right) \
     { \
@@ -260,7 +294,7 @@ GEN_BINARY_OPERATORS_VERIFIED_ON_LEFT(operator%, %=)
 // Performs math on one verified_int on the right and a builtin on the left.
 #define GEN_BINARY_OPERATORS_VERIFIED_ON_RIGHT(OPERATOR_MATH, MATH_ASSIGN) \
     template <typename L, typename R, class P> \
-    verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
+    BOOST_CXX14_CONSTEXPR verified_int<typename common_type<L, R>::type, P> OPERATOR_MATH( \
              L const & left, \
              verified_int<R, P> const & right) \
     { \
@@ -296,6 +330,12 @@ struct saturate_int
     typedef verified_int<T, saturate_overflow> type;
 };
 
+template <typename T>
+struct sticky_int
+{
+    typedef verified_int<T, sticky_overflow> type;
+};
+
 // ***********************************************
 // Even simpler usable types.  These are also
 // convenient for writing unit-tests since they
@@ -313,6 +353,7 @@ typedef throw_int<int64_t>::type  verified_int64_t;
 
 typedef throw_int<unsigned int>::type verified_uint_t;
 typedef throw_int<signed int>::type   verified_int_t;
+typedef throw_int<std::size_t>::type  verified_size_t;
 
 } // namespace boost
 
@@ -0,0 +1,120 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_arena hands out storage from a buffer by bumping a pointer, and returns it all
+// at once with reset:
+//
+//     verified_arena arena(buffer, sizeof(buffer));
+//     node *const nodes = arena.allocate<node>(count);
+//     if (!nodes) { ... }  // count nodes do not fit.
+//
+// count * sizeof(T), the rounding of the pointer up to the alignment, and the end of the
+// storage are computed with checked_mul and checked_add, so that a count read from a file
+// cannot wrap the size around to a small allocation.  An allocation which overflows, or
+// which does not fit in the rest of the buffer, returns 0 and leaves the arena unchanged.
+//
+// allocate_trailing<Header, T>(count) allocates a Header followed by count T, for the
+// header + count * sizeof(T) of a structure with a flexible array at its end.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_ARENA_HPP
+#define VERIFIED_INT_ARENA_HPP
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+
+namespace boost {
+
+class verified_arena
+{
+public:
+    verified_arena(void *const buffer, std::size_t const capacity) :
+        first_(reinterpret_cast<uintptr_t>(buffer)),
+        position_(reinterpret_cast<uintptr_t>(buffer)),
+        last_(reinterpret_cast<uintptr_t>(buffer) + capacity)
+    {
+    }
+
+    // Returns size bytes aligned to alignment, which is a power of two.
+    void *allocate(std::size_t const size, std::size_t const alignment)
+    {
+        return allocate(make_checked_result(size, e_no_overflow_detected), alignment);
+    }
+
+    // Returns uninitialized storage for count objects of T.
+    template <typename T>
+    T *allocate(std::size_t const count)
+    {
+        return static_cast<T *>(allocate(checked_mul(count, sizeof(T)), alignment_of<T>::value));
+    }
+
+    // Returns uninitialized storage for a Header followed by count objects of T, which begin
+    // at trailing<Header, T>() bytes from the Header.
+    template <typename Header, typename T>
+    Header *allocate_trailing(std::size_t const count)
+    {
+        checked_result<std::size_t> const elements = checked_mul(count, sizeof(T));
+        checked_result<std::size_t> const size = checked_add(trailing<Header, T>(), elements.value);
+        overflow_result const detected = static_cast<overflow_result>(elements.result | size.result);
+        std::size_t const alignment = alignment_of<Header>::value > alignment_of<T>::value
+            ? alignment_of<Header>::value : alignment_of<T>::value;
+        return static_cast<Header *>(allocate(make_checked_result(size.value, detected), alignment));
+    }
+
+    // The offset of the objects after a Header, which is sizeof(Header) rounded up to the
+    // alignment of T.
+    template <typename Header, typename T>
+    static BOOST_CONSTEXPR std::size_t trailing()
+    {
+        return (sizeof(Header) + alignment_of<T>::value - 1) / alignment_of<T>::value * alignment_of<T>::value;
+    }
+
+    // Returns all of the storage allocated, which must no longer be used.
+    void reset()
+    {
+        position_ = first_;
+    }
+
+    verified_size_t capacity() const
+    {
+        return verified_size_t(static_cast<uint64_t>(last_ - first_));
+    }
+
+    verified_size_t used() const
+    {
+        return verified_size_t(static_cast<uint64_t>(position_ - first_));
+    }
+
+private:
+    // Allocates a size which may already have overflowed.  The pointer is rounded up to the
+    // alignment in modular arithmetic, where aligned - position_ is the padding whether or
+    // not the rounding wrapped.  The size with the padding is compared with the rest of the
+    // buffer, which position_ never passes, so that a rounding which wrapped cannot fit.  The
+    // checks are ored rather than short-circuited, which takes fewer branches.
+    void *allocate(checked_result<std::size_t> const size, std::size_t const alignment)
+    {
+        uintptr_t const aligned = (position_ + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+        checked_result<std::size_t> const padded = checked_add(size.value, aligned - position_);
+        unsigned int const failed = static_cast<unsigned int>(size.result | padded.result) |
+                                    static_cast<unsigned int>(padded.value > last_ - position_);
+        if (failed != 0) {
+            return 0;
+        }
+        position_ = aligned + size.value;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    uintptr_t first_;
+    uintptr_t position_;
+    uintptr_t last_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_ARENA_HPP
@@ -0,0 +1,189 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// atomic_verified_int<T, P> is a verified_int<T, P> which may be shared between threads
+// without a lock.  Each fetch_add, fetch_sub and fetch_mul takes effect atomically, with
+// the result and the overflow handling of +=, -= and *= on a verified_int<T, P>, and
+// returns the previous value:
+//
+//     atomic_verified_int<uint32_t, saturate_overflow> requests;
+//     requests.fetch_add(1);
+//
+// For policies whose handle_overflow returns the wrapped value (see wraps_on_overflow), such
+// as ignore_overflow, sticky_overflow and counting_overflow<>, the operation is a single
+// atomic fetch_add or fetch_sub, and overflow is detected afterwards from the previous
+// value.  Other policies, such as saturate_overflow and throw_overflow, compute the new
+// value from the value they observed and exchange it with compare_exchange_weak, retrying
+// when another thread changed the value in between.  When P throws, the value is unchanged.
+// While retrying, P may record and handle an overflow which a retry then does not see.
+//
+// Requires C++11.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_ATOMIC_HPP
+#define VERIFIED_INT_ATOMIC_HPP
+
+#include <atomic>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#  error "verified_int_atomic.hpp requires C++11 <atomic>"
+#endif
+
+namespace boost {
+
+// ***********************************************
+// Operations
+// ***********************************************
+// Each operation detects overflow with a detection type, computes the wrapped result, and
+// performs the wrapped operation atomically, returning the previous value.
+struct atomic_addition
+{
+    static overflow_operation const operation = e_addition_operation;
+
+    template <class Detection, typename T, typename R>
+    static overflow_result detect(T const left, R const right) {
+        return Detection::detect_overflow_addition(left, right);
+    }
+    template <typename T, typename R>
+    static T wrap(T const left, R const right) {
+        return wrapped_arithmetic<T>::add(left, right);
+    }
+    template <typename T, typename R>
+    static T fetch(std::atomic<T> &value, R const right, std::memory_order const order) {
+        return value.fetch_add(static_cast<T>(right), order);
+    }
+};
+
+struct atomic_subtraction
+{
+    static overflow_operation const operation = e_subtraction_operation;
+
+    template <class Detection, typename T, typename R>
+    static overflow_result detect(T const left, R const right) {
+        return Detection::detect_overflow_subtraction(left, right);
+    }
+    template <typename T, typename R>
+    static T wrap(T const left, R const right) {
+        return wrapped_arithmetic<T>::subtract(left, right);
+    }
+    template <typename T, typename R>
+    static T fetch(std::atomic<T> &value, R const right, std::memory_order const order) {
+        return value.fetch_sub(static_cast<T>(right), order);
+    }
+};
+
+// There is no atomic multiplication, so even the wrapped product is exchanged in a loop.
+struct atomic_multiplication
+{
+    static overflow_operation const operation = e_multiplication_operation;
+
+    template <class Detection, typename T, typename R>
+    static overflow_result detect(T const left, R const right) {
+        return Detection::detect_overflow_multiplication(left, right);
+    }
+    template <typename T, typename R>
+    static T wrap(T const left, R const right) {
+        return wrapped_arithmetic<T>::multiply(left, right);
+    }
+    template <typename T, typename R>
+    static T fetch(std::atomic<T> &value, R const right, std::memory_order const order) {
+        T expected = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(expected, wrap(expected, right), order, std::memory_order_relaxed)) {
+        }
+        return expected;
+    }
+};
+
+template <typename T, class P>
+class atomic_verified_int
+{
+public:
+    typedef verified_int<T, P> value_type;
+
+    atomic_verified_int() : value_(0)
+    {
+    }
+
+    explicit atomic_verified_int(value_type const value) : value_(static_cast<T>(value))
+    {
+    }
+
+    atomic_verified_int(atomic_verified_int const &) = delete;
+    atomic_verified_int &operator=(atomic_verified_int const &) = delete;
+
+    bool is_lock_free() const
+    {
+        return value_.is_lock_free();
+    }
+
+    value_type load(std::memory_order const order = std::memory_order_seq_cst) const
+    {
+        return value_type(value_.load(order));
+    }
+
+    void store(value_type const value, std::memory_order const order = std::memory_order_seq_cst)
+    {
+        value_.store(static_cast<T>(value), order);
+    }
+
+    // Stores verified_int<T, P>(value), which P verifies before storing.
+    template <typename R>
+    void store(R const value, std::memory_order const order = std::memory_order_seq_cst)
+    {
+        store(value_type(value), order);
+    }
+
+    template <typename R>
+    value_type fetch_add(R const right, std::memory_order const order = std::memory_order_seq_cst)
+    {
+        return apply<atomic_addition>(right, order);
+    }
+
+    template <typename R>
+    value_type fetch_sub(R const right, std::memory_order const order = std::memory_order_seq_cst)
+    {
+        return apply<atomic_subtraction>(right, order);
+    }
+
+    template <typename R>
+    value_type fetch_mul(R const right, std::memory_order const order = std::memory_order_seq_cst)
+    {
+        return apply<atomic_multiplication>(right, order);
+    }
+
+private:
+    template <class Operation, typename R>
+    value_type apply(R const right, std::memory_order const order)
+    {
+        typedef typename P::template detection<T, R>::type detection_type;
+        if (wraps_on_overflow<P>::value) {
+            // The wrapped result is what P would store, so perform the operation, then
+            // check it against the value it was applied to.
+            T const previous = Operation::fetch(value_, right, order);
+            overflow_result const detected = Operation::template detect<detection_type>(previous, right);
+            P::template record_overflow<T, R>(Operation::operation, detected);
+            P::handle_overflow(Operation::wrap(previous, right), detected);
+            return value_type(previous);
+        }
+        T expected = value_.load(std::memory_order_relaxed);
+        T desired;
+        do {
+            overflow_result const detected = Operation::template detect<detection_type>(expected, right);
+            P::template record_overflow<T, R>(Operation::operation, detected);
+            desired = P::handle_overflow(Operation::wrap(expected, right), detected);
+        } while (!value_.compare_exchange_weak(expected, desired, order, std::memory_order_relaxed));
+        return value_type(expected);
+    }
+
+    std::atomic<T> value_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_ATOMIC_HPP
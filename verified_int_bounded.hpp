@@ -0,0 +1,332 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// bounded_int<Min, Max> carries the range of its value in its type.  Adding, subtracting or
+// multiplying two bounded_ints computes the range of the result at compile time, so the
+// arithmetic itself never needs an overflow check.  Converting to a verified_int<T, P> only
+// verifies the value when the range of the bounded_int does not fit in T, and that residual
+// check is the usual assignment detection of P.
+//
+//     bounded_int<0, 255> const channel(pixel_channel);
+//     bounded_int<0, 3> const offset(lane);
+//     bounded_int<4, 4> const stride(4);
+//     verified_int32_t index = channel * stride + offset;  // No run time check.
+//
+// Values are limited to the range of intmax_t.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_BOUNDED_HPP
+#define VERIFIED_INT_BOUNDED_HPP
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int.hpp"
+
+namespace boost {
+
+// Smallest integer type which holds every value in [Min, Max].  Ranges without negative
+// values are stored unsigned.
+template <intmax_t Min, intmax_t Max>
+struct bounded_storage
+{
+    typedef typename conditional<
+        (Max <= static_cast<intmax_t>(integer_traits<uint8_t>::const_max)), uint8_t,
+        typename conditional<
+            (Max <= static_cast<intmax_t>(integer_traits<uint16_t>::const_max)), uint16_t,
+            typename conditional<
+                (Max <= static_cast<intmax_t>(integer_traits<uint32_t>::const_max)), uint32_t,
+                uint64_t
+            >::type
+        >::type
+    >::type unsigned_type;
+
+    typedef typename conditional<
+        (Min >= integer_traits<int8_t>::const_min && Max <= integer_traits<int8_t>::const_max), int8_t,
+        typename conditional<
+            (Min >= integer_traits<int16_t>::const_min && Max <= integer_traits<int16_t>::const_max), int16_t,
+            typename conditional<
+                (Min >= integer_traits<int32_t>::const_min && Max <= integer_traits<int32_t>::const_max), int32_t,
+                int64_t
+            >::type
+        >::type
+    >::type signed_type;
+
+    typedef typename conditional<(Min >= 0), unsigned_type, signed_type>::type type;
+};
+
+// Whether every value in [Min, Max] is representable by T.
+template <typename T, intmax_t Min, intmax_t Max, bool is_signed = is_signed<T>::value>
+struct bounded_range_fits
+{
+    static bool const value =
+        Min >= static_cast<intmax_t>(integer_traits<T>::const_min) &&
+        Max <= static_cast<intmax_t>(integer_traits<T>::const_max);
+};
+
+template <typename T, intmax_t Min, intmax_t Max>
+struct bounded_range_fits<T, Min, Max, false>
+{
+    static bool const value = Min >= 0 &&
+        (sizeof(T) >= sizeof(intmax_t) || Max <= static_cast<intmax_t>(integer_traits<T>::const_max));
+};
+
+// Compile time arithmetic on the bounds.  A range whose bounds overflow intmax_t fails to
+// compile.
+template <intmax_t Left, intmax_t Right>
+struct bounded_sum
+{
+    BOOST_STATIC_ASSERT(Right >= 0 ? Left <= integer_traits<intmax_t>::const_max - Right
+                                   : Left >= integer_traits<intmax_t>::const_min - Right);
+    static intmax_t const value = Left + Right;
+};
+
+template <intmax_t Left, intmax_t Right>
+struct bounded_difference
+{
+    BOOST_STATIC_ASSERT(Right >= 0 ? Left >= integer_traits<intmax_t>::const_min + Right
+                                   : Left <= integer_traits<intmax_t>::const_max + Right);
+    static intmax_t const value = Left - Right;
+};
+
+template <intmax_t Left, intmax_t Right>
+struct bounded_product
+{
+    // The divisors are never zero, which keeps the unused branches well formed.
+    static intmax_t const safe_left = Left == 0 ? 1 : Left;
+    static intmax_t const safe_right = Right == 0 ? 1 : Right;
+    static bool const is_representable =
+        Left == 0 || Right == 0 ||
+        (Left > 0 ? (Right > 0 ? Left <= integer_traits<intmax_t>::const_max / safe_right
+                               : Right >= integer_traits<intmax_t>::const_min / safe_left)
+                  : (Right > 0 ? Left >= integer_traits<intmax_t>::const_min / safe_right
+                               : Left >= integer_traits<intmax_t>::const_max / safe_right));
+    BOOST_STATIC_ASSERT(is_representable);
+    static intmax_t const value = is_representable ? Left * Right : 0;
+};
+
+template <intmax_t A, intmax_t B, intmax_t C, intmax_t D>
+struct bounded_extremes
+{
+    static intmax_t const min_ab = A < B ? A : B;
+    static intmax_t const min_cd = C < D ? C : D;
+    static intmax_t const max_ab = A < B ? B : A;
+    static intmax_t const max_cd = C < D ? D : C;
+    static intmax_t const min = min_ab < min_cd ? min_ab : min_cd;
+    static intmax_t const max = max_ab < max_cd ? max_cd : max_ab;
+};
+
+// Detects whether value lies outside of [Min, Max].
+template <intmax_t Min, intmax_t Max, typename T>
+inline BOOST_CXX14_CONSTEXPR overflow_result detect_bounded_overflow(T const value)
+{
+    overflow_result result = e_no_overflow_detected;
+    if (sign_of<T>::is_negative(value)) {
+        intmax_t const negative = static_cast<intmax_t>(value);
+        if (negative < Min) {
+            result = e_negative_overflow_detected;
+        } else if (negative > Max) {
+            result = e_positive_overflow_detected;
+        }
+    } else {
+        uintmax_t const magnitude = static_cast<uintmax_t>(value);
+        if (Max < 0 || magnitude > static_cast<uintmax_t>(Max)) {
+            result = e_positive_overflow_detected;
+        } else if (Min > 0 && magnitude < static_cast<uintmax_t>(Min)) {
+            result = e_negative_overflow_detected;
+        }
+    }
+    return result;
+}
+
+// Converts to verified_int<T, P>, verifying only when the range does not fit in T.
+template <typename T, class P, bool does_range_fit>
+struct bounded_conversion
+{
+    template <typename V>
+    static BOOST_CXX14_CONSTEXPR verified_int<T, P> convert(V const value)
+    {
+        return verified_int<T, P>(static_cast<T>(value));
+    }
+};
+
+template <typename T, class P>
+struct bounded_conversion<T, P, false>
+{
+    template <typename V>
+    static BOOST_CXX14_CONSTEXPR verified_int<T, P> convert(V const value)
+    {
+        return verified_int<T, P>(value);
+    }
+};
+
+template <intmax_t Min, intmax_t Max>
+class bounded_int
+{
+    BOOST_STATIC_ASSERT(Min <= Max);
+
+public:
+    typedef typename bounded_storage<Min, Max>::type value_type;
+
+    static intmax_t const min_value = Min;
+    static intmax_t const max_value = Max;
+
+    // Default constructor.  Zero, or the bound nearest to zero when zero is out of range.
+    BOOST_CONSTEXPR bounded_int() : value_(static_cast<value_type>(Min > 0 ? Min : (Max < 0 ? Max : 0)))
+    {
+    }
+
+    // Widening constructor.  Only ranges contained in [Min, Max] convert without a check.
+    template <intmax_t OtherMin, intmax_t OtherMax>
+    BOOST_CXX14_CONSTEXPR bounded_int(bounded_int<OtherMin, OtherMax> const & other) :
+        value_(static_cast<value_type>(other.value()))
+    {
+        BOOST_STATIC_ASSERT(OtherMin >= Min && OtherMax <= Max);
+    }
+
+    // Conversion constructors.  Throws when the value lies outside of [Min, Max].
+    #define GEN_CONVERSION_CONSTRUCTOR(TYPE) \
+    explicit BOOST_CXX14_CONSTEXPR bounded_int(TYPE const value) : value_(static_cast<value_type>(value)) \
+    { \
+        switch (detect_bounded_overflow<Min, Max>(value)) \
+        { \
+        case e_positive_overflow_detected: \
+            BOOST_THROW_EXCEPTION(positive_overflow_detected()); \
+            break; \
+        case e_negative_overflow_detected: \
+            BOOST_THROW_EXCEPTION(negative_overflow_detected()); \
+            break; \
+        default: \
+            break; \
+        } \
+    }
+    GEN_CONVERSION_CONSTRUCTOR(uint8_t)
+    GEN_CONVERSION_CONSTRUCTOR(uint16_t)
+    GEN_CONVERSION_CONSTRUCTOR(uint32_t)
+    GEN_CONVERSION_CONSTRUCTOR(uint64_t)
+    GEN_CONVERSION_CONSTRUCTOR(int8_t)
+    GEN_CONVERSION_CONSTRUCTOR(int16_t)
+    GEN_CONVERSION_CONSTRUCTOR(int32_t)
+    GEN_CONVERSION_CONSTRUCTOR(int64_t)
+    #undef GEN_CONVERSION_CONSTRUCTOR
+
+    BOOST_CONSTEXPR value_type value() const
+    {
+        return value_;
+    }
+
+    // Conversion to a verified_int.  Verifies the value only when [Min, Max] does not fit in T.
+    template <typename T, class P>
+    BOOST_CXX14_CONSTEXPR operator verified_int<T, P>() const
+    {
+        return bounded_conversion<T, P, bounded_range_fits<T, Min, Max>::value>::convert(value_);
+    }
+
+private:
+    template <intmax_t OtherMin, intmax_t OtherMax> friend class bounded_int;
+
+    template <intmax_t RMin, intmax_t RMax>
+    friend BOOST_CONSTEXPR bounded_int<bounded_difference<0, RMax>::value, bounded_difference<0, RMin>::value>
+    operator-(bounded_int<RMin, RMax> const & right);
+
+    template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+    friend BOOST_CONSTEXPR bounded_int<bounded_sum<LMin, RMin>::value, bounded_sum<LMax, RMax>::value>
+    operator+(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right);
+
+    template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+    friend BOOST_CONSTEXPR bounded_int<bounded_difference<LMin, RMax>::value, bounded_difference<LMax, RMin>::value>
+    operator-(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right);
+
+    template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+    friend BOOST_CONSTEXPR bounded_int<
+        bounded_extremes<bounded_product<LMin, RMin>::value, bounded_product<LMin, RMax>::value,
+                         bounded_product<LMax, RMin>::value, bounded_product<LMax, RMax>::value>::min,
+        bounded_extremes<bounded_product<LMin, RMin>::value, bounded_product<LMin, RMax>::value,
+                         bounded_product<LMax, RMin>::value, bounded_product<LMax, RMax>::value>::max>
+    operator*(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right);
+
+    // Tag for results whose range has been proven at compile time.
+    struct unchecked {};
+
+    BOOST_CONSTEXPR bounded_int(intmax_t const value, unchecked) : value_(static_cast<value_type>(value))
+    {
+    }
+
+    value_type value_;
+};
+
+// ***********************************************
+// Binary math operators
+// ***********************************************
+// The exact result always lies within the computed range, so it is computed in intmax_t
+// and narrowed to the storage of the result without a check.
+template <intmax_t RMin, intmax_t RMax>
+inline BOOST_CONSTEXPR bounded_int<bounded_difference<0, RMax>::value, bounded_difference<0, RMin>::value>
+operator-(bounded_int<RMin, RMax> const & right)
+{
+    typedef bounded_int<bounded_difference<0, RMax>::value, bounded_difference<0, RMin>::value> result_type;
+    return result_type(-static_cast<intmax_t>(right.value()), typename result_type::unchecked());
+}
+
+template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+inline BOOST_CONSTEXPR bounded_int<bounded_sum<LMin, RMin>::value, bounded_sum<LMax, RMax>::value>
+operator+(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right)
+{
+    typedef bounded_int<bounded_sum<LMin, RMin>::value, bounded_sum<LMax, RMax>::value> result_type;
+    return result_type(static_cast<intmax_t>(left.value()) + static_cast<intmax_t>(right.value()),
+                       typename result_type::unchecked());
+}
+
+template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+inline BOOST_CONSTEXPR bounded_int<bounded_difference<LMin, RMax>::value, bounded_difference<LMax, RMin>::value>
+operator-(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right)
+{
+    typedef bounded_int<bounded_difference<LMin, RMax>::value, bounded_difference<LMax, RMin>::value> result_type;
+    return result_type(static_cast<intmax_t>(left.value()) - static_cast<intmax_t>(right.value()),
+                       typename result_type::unchecked());
+}
+
+template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax>
+inline BOOST_CONSTEXPR bounded_int<
+    bounded_extremes<bounded_product<LMin, RMin>::value, bounded_product<LMin, RMax>::value,
+                     bounded_product<LMax, RMin>::value, bounded_product<LMax, RMax>::value>::min,
+    bounded_extremes<bounded_product<LMin, RMin>::value, bounded_product<LMin, RMax>::value,
+                     bounded_product<LMax, RMin>::value, bounded_product<LMax, RMax>::value>::max>
+operator*(bounded_int<LMin, LMax> const & left, bounded_int<RMin, RMax> const & right)
+{
+    typedef bounded_extremes<bounded_product<LMin, RMin>::value, bounded_product<LMin, RMax>::value,
+                             bounded_product<LMax, RMin>::value, bounded_product<LMax, RMax>::value> extremes;
+    typedef bounded_int<extremes::min, extremes::max> result_type;
+    return result_type(static_cast<intmax_t>(left.value()) * static_cast<intmax_t>(right.value()),
+                       typename result_type::unchecked());
+}
+
+// ***********************************************
+// Comparison operators
+// ***********************************************
+#define GEN_BOUNDED_COMPARISON_OPERATOR(OPERATOR_COMPARE, COMPARE) \
+    template <intmax_t LMin, intmax_t LMax, intmax_t RMin, intmax_t RMax> \
+    inline BOOST_CONSTEXPR bool OPERATOR_COMPARE( \
+            bounded_int<LMin, LMax> const & left, \
+            bounded_int<RMin, RMax> const & right) \
+    { \
+        return static_cast<intmax_t>(left.value()) COMPARE static_cast<intmax_t>(right.value()); \
+    }
+GEN_BOUNDED_COMPARISON_OPERATOR(operator==, ==)
+GEN_BOUNDED_COMPARISON_OPERATOR(operator!=, !=)
+GEN_BOUNDED_COMPARISON_OPERATOR(operator<, <)
+GEN_BOUNDED_COMPARISON_OPERATOR(operator<=, <=)
+GEN_BOUNDED_COMPARISON_OPERATOR(operator>, >)
+GEN_BOUNDED_COMPARISON_OPERATOR(operator>=, >=)
+#undef GEN_BOUNDED_COMPARISON_OPERATOR
+
+} // namespace boost
+
+#endif // VERIFIED_INT_BOUNDED_HPP
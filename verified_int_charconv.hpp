@@ -0,0 +1,348 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_from_chars parses an integer from text directly into a verified_int<T, P>, as
+// std::from_chars does for built-ins, without locales and without parsing a wider type
+// first:
+//
+//     verified_int32_t quantity;
+//     verified_from_chars_result const parsed = verified_from_chars(first, last, quantity);
+//     if (parsed.ptr == first) { ... }  // No digits.
+//
+// The text is an optional '-', for signed T only, followed by digits in base, which is
+// between 2 and 36.  There is no leading whitespace, '+' or "0x".  ptr points past the last
+// digit, even when the number overflows, and is first when there are no digits, in which
+// case value is unchanged.
+//
+// A number out of the range of T is an assignment overflow, e_positive_overflow_detected or
+// e_negative_overflow_detected by sign, which is recorded and handled by P and returned in
+// result.  P handles the value wrapped to T, as verified_int<T, P> does, so that
+// saturate_overflow stores a limit of T and ignore_overflow stores the low bits.
+//
+// Decimal digits of 64-bit integers are parsed eight at a time within a 64-bit word where
+// the target is little endian.
+//
+// verified_to_chars writes a verified_int<T, P> into a buffer of the caller, as
+// std::to_chars does, without allocating and without locales:
+//
+//     char buffer[verified_chars<int32_t>::size];
+//     char *const end = verified_to_chars(buffer, buffer + sizeof(buffer), quantity).ptr;
+//
+// Decimal digits are written two at a time from a table of digit pairs.  When the number
+// does not fit, ptr is last, fits is false, and the contents of the buffer are unspecified.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_CHARCONV_HPP
+#define VERIFIED_INT_CHARCONV_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include "verified_int.hpp"
+
+#if BOOST_ENDIAN_LITTLE_BYTE
+#  define BOOST_VERIFIED_INT_HAS_SWAR_DIGITS
+#endif
+
+namespace boost {
+
+struct verified_from_chars_result
+{
+    char const *ptr;
+    overflow_result result;
+};
+
+// ***********************************************
+// Digits
+// ***********************************************
+// The value of a digit in bases up to 36, or at least 36 when c is not a digit.
+inline unsigned int digit_value(char const c)
+{
+    unsigned int const digit = static_cast<unsigned int>(static_cast<unsigned char>(c)) - '0';
+    if (digit < 10) {
+        return digit;
+    }
+    unsigned int const letter = (static_cast<unsigned int>(static_cast<unsigned char>(c)) | 0x20U) - 'a';
+    return letter < 26 ? letter + 10 : 36;
+}
+
+#if defined(BOOST_VERIFIED_INT_HAS_SWAR_DIGITS)
+// Eight characters in a 64-bit word, the first in the lowest byte.
+struct eight_digits
+{
+    static uint64_t load(char const *const characters)
+    {
+        uint64_t word;
+        std::memcpy(&word, characters, sizeof(word));
+        return word;
+    }
+
+    // Each byte is between 0x30 and 0x39 when its high nibble is 3 and adding 6 does not
+    // carry into the high nibble.
+    static bool are_digits(uint64_t const word)
+    {
+        return ((word & 0xF0F0F0F0F0F0F0F0ULL) |
+                (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+    }
+
+    // Combines pairs of digits, then pairs of pairs, then the two halves.
+    static uint32_t value(uint64_t word)
+    {
+        word -= 0x3030303030303030ULL;
+        word = word * 10 + (word >> 8);
+        word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        return static_cast<uint32_t>(word);
+    }
+};
+#endif
+
+// The most digits in base which always fit in 64 bits, for bases 2 to 36.
+inline std::ptrdiff_t exact_digits(unsigned int const base)
+{
+    static unsigned char const digits[37] = {
+        0, 0, 64, 40, 32, 27, 24, 22, 21, 20, 19, 18, 17, 17, 16, 16, 16, 15, 15,
+        15, 14, 14, 14, 14, 13, 13, 13, 13, 13, 13, 13, 12, 12, 12, 12, 12, 12
+    };
+    return digits[base];
+}
+
+// Parses the digits of a number with more than exact_digits, skipping leading zeros and
+// checking each digit for overflow.
+inline BOOST_NOINLINE char const *parse_long_magnitude(char const *const first, char const *const last,
+                                                       unsigned int const base, uint64_t &magnitude,
+                                                       bool &overflowed)
+{
+    char const *position = first;
+    while (position != last && *position == '0') {
+        ++position;
+    }
+    uint64_t const limit = integer_traits<uint64_t>::const_max / base;
+    unsigned int const limit_digit = static_cast<unsigned int>(integer_traits<uint64_t>::const_max % base);
+    uint64_t value = 0;
+    bool exceeded = false;
+    for (; position != last; ++position) {
+        unsigned int const digit = digit_value(*position);
+        if (digit >= base) {
+            break;
+        }
+        exceeded |= value > limit || (value == limit && digit > limit_digit);
+        value = value * base + digit;
+    }
+    magnitude = value;
+    overflowed = exceeded;
+    return position;
+}
+
+// Parses the digits at the start of [first, last) in base, returning the end of the digits.
+// magnitude holds their value modulo 2^64, and overflowed is set when it is not exact.  The
+// digits are parsed without checking for overflow, and only a number with more digits than
+// always fit in 64 bits is parsed again with checks.  Testing for eight digits only pays
+// when most numbers are that long, so is_long_expected enables parsing eight at a time.
+inline char const *parse_magnitude(char const *const first, char const *const last, unsigned int const base,
+                                   bool const is_long_expected, uint64_t &magnitude, bool &overflowed)
+{
+    char const *position = first;
+    uint64_t value = 0;
+    if (base == 10) {
+#if defined(BOOST_VERIFIED_INT_HAS_SWAR_DIGITS)
+        while (is_long_expected && last - position >= 8) {
+            uint64_t const word = eight_digits::load(position);
+            if (!eight_digits::are_digits(word)) {
+                break;
+            }
+            value = value * 100000000U + eight_digits::value(word);
+            position += 8;
+        }
+#endif
+        for (; position != last; ++position) {
+            unsigned int const digit = static_cast<unsigned int>(static_cast<unsigned char>(*position)) - '0';
+            if (digit >= 10) {
+                break;
+            }
+            value = value * 10 + digit;
+        }
+    } else {
+        for (; position != last; ++position) {
+            unsigned int const digit = digit_value(*position);
+            if (digit >= base) {
+                break;
+            }
+            value = value * base + digit;
+        }
+    }
+    if (position - first > exact_digits(base)) {
+        return parse_long_magnitude(first, last, base, magnitude, overflowed);
+    }
+    magnitude = value;
+    overflowed = false;
+    return position;
+}
+
+template <typename T, class P>
+inline verified_from_chars_result verified_from_chars(char const *const first, char const *const last,
+                                                      verified_int<T, P> &value, int const base = 10)
+{
+    typedef typename P::template detection<T, T>::type detection_type;
+    bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+    // The largest magnitudes of each sign.
+    uint64_t const positive_limit = static_cast<uint64_t>(integer_traits<T>::const_max);
+    uint64_t const negative_limit = is_signed<T>::value ? positive_limit + 1 : 0;
+
+    bool const negative = is_signed<T>::value && first != last && *first == '-';
+    char const *const digits = negative ? first + 1 : first;
+    uint64_t magnitude;
+    bool overflowed;
+    char const *const end = parse_magnitude(digits, last, static_cast<unsigned int>(base), sizeof(T) >= 8,
+                                            magnitude, overflowed);
+    if (end == digits) {
+        verified_from_chars_result const none = { first, e_no_overflow_detected };
+        return none;
+    }
+
+    overflow_result detected = e_no_overflow_detected;
+    if (is_detecting && (overflowed || magnitude > (negative ? negative_limit : positive_limit))) {
+        detected = negative ? e_negative_overflow_detected : e_positive_overflow_detected;
+    }
+    T const wrapped = static_cast<T>(negative ? 0 - magnitude : magnitude);
+    P::template record_overflow<T, T>(e_assignment_operation, detected);
+    value = verified_int<T, P>(P::handle_overflow(wrapped, detected));
+    verified_from_chars_result const parsed = { end, detected };
+    return parsed;
+}
+
+// ***********************************************
+// Formatting
+// ***********************************************
+struct verified_to_chars_result
+{
+    char *ptr;
+    bool fits;
+};
+
+// Characters needed for any T in decimal, including the sign.
+template <typename T>
+struct verified_chars
+{
+    static std::size_t const size = integer_traits<T>::digits10 + 1 + (is_signed<T>::value ? 1 : 0);
+};
+
+// "00010203...99", the two digits of each number below 100.
+inline char const *digit_pairs()
+{
+    static char const pairs[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    return pairs;
+}
+
+// Digits of value in decimal, testing four at a time.
+template <typename U>
+inline std::ptrdiff_t decimal_digits(U value)
+{
+    std::ptrdiff_t digits = 1;
+    while (true) {
+        if (value < 10U) {
+            return digits;
+        }
+        if (value < 100U) {
+            return digits + 1;
+        }
+        if (value < 1000U) {
+            return digits + 2;
+        }
+        if (value < 10000U) {
+            return digits + 3;
+        }
+        value /= 10000U;
+        digits += 4;
+    }
+}
+
+// Writes the digits of value backwards from end, two at a time.
+template <typename U>
+inline void write_decimal(char *end, U value)
+{
+    char const *const pairs = digit_pairs();
+    while (value >= 100U) {
+        unsigned int const pair = static_cast<unsigned int>(value % 100U) * 2;
+        value /= 100U;
+        end -= 2;
+        std::memcpy(end, pairs + pair, 2);
+    }
+    if (value >= 10U) {
+        std::memcpy(end - 2, pairs + value * 2, 2);
+    } else {
+        end[-1] = static_cast<char>('0' + value);
+    }
+}
+
+template <typename U>
+inline verified_to_chars_result write_magnitude(char *const first, char *const last, U value, unsigned int const base)
+{
+    verified_to_chars_result const too_long = { last, false };
+    if (base == 10) {
+        std::ptrdiff_t const digits = decimal_digits(value);
+        if (last - first < digits) {
+            return too_long;
+        }
+        write_decimal(first + digits, value);
+        verified_to_chars_result const written = { first + digits, true };
+        return written;
+    }
+    // Other bases are written backwards into a buffer for the most digits, which are those
+    // of base 2, and then copied.
+    char digits[sizeof(U) * 8];
+    char *begin = digits + sizeof(digits);
+    do {
+        *--begin = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+        value /= base;
+    } while (value != 0);
+    std::ptrdiff_t const count = digits + sizeof(digits) - begin;
+    if (last - first < count) {
+        return too_long;
+    }
+    std::memcpy(first, begin, static_cast<std::size_t>(count));
+    verified_to_chars_result const written = { first + count, true };
+    return written;
+}
+
+// Writes value in base, between 2 and 36, with a '-' when it is negative and lowercase
+// letters for digits above 9.
+template <typename T, class P>
+inline verified_to_chars_result verified_to_chars(char *const first, char *const last,
+                                                  verified_int<T, P> const value, int const base = 10)
+{
+    // At least 32 bits, so that division by constants is cheap for every T.
+    typedef typename conditional<(sizeof(T) < sizeof(uint32_t)), uint32_t,
+                                 typename make_unsigned<T>::type>::type unsigned_type;
+    typedef typename make_unsigned<T>::type bits_type;
+    bits_type const bits = static_cast<bits_type>(static_cast<T>(value));
+    bool const negative = sign_of<T>::is_negative(static_cast<T>(value));
+    // Negating the bits has the magnitude of every negative T, including the minimum.
+    unsigned_type const magnitude =
+        negative ? wrapped_arithmetic<bits_type>::subtract(bits_type(0), bits) : bits;
+    if (!negative) {
+        return write_magnitude(first, last, magnitude, static_cast<unsigned int>(base));
+    }
+    if (first == last) {
+        verified_to_chars_result const too_long = { last, false };
+        return too_long;
+    }
+    *first = '-';
+    return write_magnitude(first + 1, last, magnitude, static_cast<unsigned int>(base));
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_CHARCONV_HPP
@@ -0,0 +1,147 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Checked arithmetic which reports overflow in its result instead of throwing.
+//
+//     checked_result<int32_t> const sum = checked_add(left, right);
+//     if (sum.result != e_no_overflow_detected) {
+//         ...  // Cold path.
+//     }
+//
+// checked_result is trivially copyable and returned in registers.  The operations check the
+// result against the type of the left operand, as the compound assignment operators of
+// verified_int do, using do_detect_overflow.  On overflow the value holds the result wrapped
+// to the left type, as a built-in computes it.  Division by zero is undefined, as it is for
+// built-ins.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_CHECKED_HPP
+#define VERIFIED_INT_CHECKED_HPP
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include "verified_int_overflow_detection.hpp"
+
+namespace boost {
+
+template <typename T>
+struct checked_result
+{
+    T value;
+    overflow_result result;
+};
+
+template <typename T>
+inline BOOST_CXX14_CONSTEXPR checked_result<T> make_checked_result(T const value, overflow_result const result)
+{
+    checked_result<T> const checked = { value, result };
+    return checked;
+}
+
+// Modular arithmetic in the width of L, which never overflows.
+template <typename L>
+struct wrapped_arithmetic
+{
+    // At least unsigned int, so that operands are not promoted to int.
+    typedef typename conditional<
+        (sizeof(L) < sizeof(unsigned int)),
+        unsigned int,
+        typename make_unsigned<L>::type
+    >::type unsigned_type;
+
+    template <typename R>
+    static BOOST_CXX14_CONSTEXPR L add(L const left, R const right) {
+        return static_cast<L>(static_cast<unsigned_type>(left) + static_cast<unsigned_type>(right));
+    }
+    template <typename R>
+    static BOOST_CXX14_CONSTEXPR L subtract(L const left, R const right) {
+        return static_cast<L>(static_cast<unsigned_type>(left) - static_cast<unsigned_type>(right));
+    }
+    template <typename R>
+    static BOOST_CXX14_CONSTEXPR L multiply(L const left, R const right) {
+        return static_cast<L>(static_cast<unsigned_type>(left) * static_cast<unsigned_type>(right));
+    }
+    // Dividing a signed value by -1 negates, which wraps for the minimum value rather than
+    // trapping.  An unsigned value is divided as a built-in, where -1 may convert to the
+    // maximum of an unsigned type.
+    template <typename R>
+    static BOOST_CXX14_CONSTEXPR L divide(L const left, R const right) {
+        return is_signed<L>::value && sign_of<R>::is_negative(right) && right == static_cast<R>(-1)
+            ? static_cast<L>(static_cast<unsigned_type>(0) - static_cast<unsigned_type>(left))
+            : static_cast<L>(left / right);
+    }
+};
+
+// Checked operations using the detection of a policy.
+template <class Detection>
+struct checked_arithmetic
+{
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR checked_result<L> convert(R const right) {
+        typedef typename Detection::template detection<L, R>::type detection_type;
+        return make_checked_result(static_cast<L>(right), detection_type::detect_overflow_assignment(right));
+    }
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR checked_result<L> add(L const left, R const right) {
+        typedef typename Detection::template detection<L, R>::type detection_type;
+        return make_checked_result(wrapped_arithmetic<L>::add(left, right),
+                                   detection_type::detect_overflow_addition(left, right));
+    }
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR checked_result<L> subtract(L const left, R const right) {
+        typedef typename Detection::template detection<L, R>::type detection_type;
+        return make_checked_result(wrapped_arithmetic<L>::subtract(left, right),
+                                   detection_type::detect_overflow_subtraction(left, right));
+    }
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR checked_result<L> multiply(L const left, R const right) {
+        typedef typename Detection::template detection<L, R>::type detection_type;
+        return make_checked_result(wrapped_arithmetic<L>::multiply(left, right),
+                                   detection_type::detect_overflow_multiplication(left, right));
+    }
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR checked_result<L> divide(L const left, R const right) {
+        typedef typename Detection::template detection<L, R>::type detection_type;
+        return make_checked_result(wrapped_arithmetic<L>::divide(left, right),
+                                   detection_type::detect_overflow_division(left, right));
+    }
+};
+
+template <typename T, typename R>
+inline BOOST_CXX14_CONSTEXPR checked_result<T> checked_convert(R const right)
+{
+    return checked_arithmetic<overflow_detection_on>::template convert<T>(right);
+}
+
+template <typename L, typename R>
+inline BOOST_CXX14_CONSTEXPR checked_result<L> checked_add(L const left, R const right)
+{
+    return checked_arithmetic<overflow_detection_on>::add(left, right);
+}
+
+template <typename L, typename R>
+inline BOOST_CXX14_CONSTEXPR checked_result<L> checked_sub(L const left, R const right)
+{
+    return checked_arithmetic<overflow_detection_on>::subtract(left, right);
+}
+
+template <typename L, typename R>
+inline BOOST_CXX14_CONSTEXPR checked_result<L> checked_mul(L const left, R const right)
+{
+    return checked_arithmetic<overflow_detection_on>::multiply(left, right);
+}
+
+template <typename L, typename R>
+inline BOOST_CXX14_CONSTEXPR checked_result<L> checked_div(L const left, R const right)
+{
+    return checked_arithmetic<overflow_detection_on>::divide(left, right);
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_CHECKED_HPP
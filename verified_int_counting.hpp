@@ -0,0 +1,305 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// counting_overflow<Policy> counts every overflow detected by a verified_int, keyed by the
+// verified type, the operand type, the operation and the direction, and then handles the
+// overflow with Policy.  For example verified_int<int32_t, counting_overflow<saturate_overflow> >
+// saturates and counts, and counting_overflow<> wraps like a built-in and counts.
+//
+// Each thread increments its own counters, without locks and without branching on whether
+// overflow was detected.  overflow_counters aggregates the counters of every thread on
+// demand, and writes them in the Prometheus text exposition format:
+//
+//     # TYPE verified_int_overflows_total counter
+//     verified_int_overflows_total{type="uint8_t",operand="int32_t",operation="addition",direction="positive"} 3
+//
+// Requires C++11.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_COUNTING_HPP
+#define VERIFIED_INT_COUNTING_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int_policies.hpp"
+#include "verified_int_overflow_detection.hpp"
+
+#if defined(BOOST_NO_CXX11_THREAD_LOCAL) || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX)
+#  error "verified_int_counting.hpp requires C++11 thread_local, <atomic> and <mutex>"
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#  include <cstring>
+#  define BOOST_VERIFIED_INT_HAS_UNIX_SOCKETS
+#endif
+
+namespace boost {
+
+// Index of an integer type among the eight fixed width types, by size and signedness.
+template <typename T>
+struct counted_type_index
+{
+    static std::size_t const value =
+        (sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3) + (is_signed<T>::value ? 4 : 0);
+};
+
+class overflow_counters
+{
+public:
+    static std::size_t const type_count = 8;
+    static std::size_t const operation_count = 5;
+    // e_no_overflow_detected has a slot too, which is never reported, so that recording
+    // does not branch on the overflow_result.
+    static std::size_t const result_count = 3;
+    static std::size_t const counter_count = type_count * type_count * operation_count * result_count;
+
+    template <typename T, typename R>
+    static std::size_t index_of(overflow_operation const operation, overflow_result const detected)
+    {
+        return ((counted_type_index<T>::value * type_count + counted_type_index<R>::value) *
+                operation_count + operation) * result_count + detected;
+    }
+
+    // Counts one result of the calling thread.  Only the calling thread writes its
+    // counters, so a relaxed load and store suffice.
+    static void record(std::size_t const index)
+    {
+        std::atomic<uint64_t> &counter = local().counts_[index];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Overflows of every thread, including threads which have exited.
+    template <typename T, typename R>
+    static uint64_t count(overflow_operation const operation, overflow_result const detected)
+    {
+        return aggregate()[index_of<T, R>(operation, detected)];
+    }
+
+    static uint64_t total()
+    {
+        std::vector<uint64_t> const counts = aggregate();
+        uint64_t sum = 0;
+        for (std::size_t index = 0; index < counter_count; ++index) {
+            if (index % result_count != e_no_overflow_detected) {
+                sum += counts[index];
+            }
+        }
+        return sum;
+    }
+
+    // Restarts every count from zero.  Overflows recorded concurrently by other threads
+    // may be lost.
+    static void reset()
+    {
+        registry &all = instance();
+        std::lock_guard<std::mutex> const lock(all.mutex);
+        for (std::size_t index = 0; index < counter_count; ++index) {
+            all.retired[index] = 0;
+        }
+        for (std::size_t thread = 0; thread < all.threads.size(); ++thread) {
+            for (std::size_t index = 0; index < counter_count; ++index) {
+                all.threads[thread]->counts_[index].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Writes every non zero count in the Prometheus text exposition format.
+    static void write_prometheus(std::ostream &out)
+    {
+        static char const *const type_names[type_count] = {
+            "uint8_t", "uint16_t", "uint32_t", "uint64_t", "int8_t", "int16_t", "int32_t", "int64_t"
+        };
+        static char const *const operation_names[operation_count] = {
+            "assignment", "addition", "subtraction", "multiplication", "division"
+        };
+        static char const *const result_names[result_count] = { "none", "positive", "negative" };
+
+        std::vector<uint64_t> const counts = aggregate();
+        out << "# HELP verified_int_overflows_total Overflows detected by verified_int.\n"
+               "# TYPE verified_int_overflows_total counter\n";
+        for (std::size_t index = 0; index < counter_count; ++index) {
+            std::size_t const result = index % result_count;
+            if (result == e_no_overflow_detected || counts[index] == 0) {
+                continue;
+            }
+            std::size_t const operation = index / result_count % operation_count;
+            std::size_t const operand = index / (result_count * operation_count) % type_count;
+            std::size_t const type = index / (result_count * operation_count * type_count);
+            out << "verified_int_overflows_total{type=\"" << type_names[type]
+                << "\",operand=\"" << type_names[operand]
+                << "\",operation=\"" << operation_names[operation]
+                << "\",direction=\"" << result_names[result] << "\"} " << counts[index] << '\n';
+        }
+    }
+
+    // Replaces the file at path, returning false when it cannot be written.  The counts are
+    // written to a temporary file named for the process and the call, so that exporters
+    // writing the same path concurrently do not write the same temporary file.
+    static bool write_prometheus_file(char const *const path)
+    {
+        static std::atomic<unsigned long> sequence(0);
+        std::ostringstream name;
+        name << path << '.';
+#if defined(BOOST_VERIFIED_INT_HAS_UNIX_SOCKETS)
+        name << static_cast<long>(::getpid()) << '.';
+#endif
+        name << sequence.fetch_add(1, std::memory_order_relaxed) << ".tmp";
+        std::string const temporary = name.str();
+        {
+            std::ofstream out(temporary.c_str(), std::ios::out | std::ios::trunc);
+            write_prometheus(out);
+            if (!out.flush()) {
+                out.close();
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        if (std::rename(temporary.c_str(), path) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+#if defined(BOOST_VERIFIED_INT_HAS_UNIX_SOCKETS)
+    // Sends the counts to the stream socket listening at path, returning false when the
+    // connection or the write fails.
+    static bool write_prometheus_socket(char const *const path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        if (std::strlen(path) >= sizeof(address.sun_path)) {
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path);
+
+        int const socket_handle = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (socket_handle < 0) {
+            return false;
+        }
+        // A collector which closes the connection must not raise SIGPIPE in the process.
+#if defined(MSG_NOSIGNAL)
+        int const send_flags = MSG_NOSIGNAL;
+#else
+        int const send_flags = 0;
+#  if defined(SO_NOSIGPIPE)
+        int const no_sigpipe = 1;
+        ::setsockopt(socket_handle, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#  endif
+#endif
+        std::ostringstream out;
+        write_prometheus(out);
+        std::string const text = out.str();
+        bool written = ::connect(socket_handle, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) == 0;
+        for (std::size_t offset = 0; written && offset < text.size();) {
+            ssize_t const sent = ::send(socket_handle, text.data() + offset, text.size() - offset, send_flags);
+            written = sent > 0;
+            offset += written ? static_cast<std::size_t>(sent) : 0;
+        }
+        ::close(socket_handle);
+        return written;
+    }
+#endif
+
+private:
+    struct thread_counters;
+
+    struct registry
+    {
+        registry() : retired(counter_count, 0) {}
+
+        std::mutex mutex;
+        std::vector<thread_counters *> threads;
+        // Counts of threads which have exited.
+        std::vector<uint64_t> retired;
+    };
+
+    // Registers itself on the first overflow check of a thread, and folds its counts into
+    // the registry when the thread exits.
+    struct thread_counters
+    {
+        thread_counters() : counts_()
+        {
+            registry &all = instance();
+            std::lock_guard<std::mutex> const lock(all.mutex);
+            all.threads.push_back(this);
+        }
+
+        ~thread_counters()
+        {
+            registry &all = instance();
+            std::lock_guard<std::mutex> const lock(all.mutex);
+            for (std::size_t index = 0; index < counter_count; ++index) {
+                all.retired[index] += counts_[index].load(std::memory_order_relaxed);
+            }
+            for (std::size_t thread = 0; thread < all.threads.size(); ++thread) {
+                if (all.threads[thread] == this) {
+                    all.threads.erase(all.threads.begin() + thread);
+                    break;
+                }
+            }
+        }
+
+        std::atomic<uint64_t> counts_[counter_count];
+    };
+
+    static registry &instance()
+    {
+        static registry all;
+        return all;
+    }
+
+    static thread_counters &local()
+    {
+        static thread_local thread_counters counters;
+        return counters;
+    }
+
+    static std::vector<uint64_t> aggregate()
+    {
+        registry &all = instance();
+        std::lock_guard<std::mutex> const lock(all.mutex);
+        std::vector<uint64_t> counts(all.retired);
+        for (std::size_t thread = 0; thread < all.threads.size(); ++thread) {
+            for (std::size_t index = 0; index < counter_count; ++index) {
+                counts[index] += all.threads[thread]->counts_[index].load(std::memory_order_relaxed);
+            }
+        }
+        return counts;
+    }
+};
+
+// Counts each overflow, then handles it with Policy.  Detection defaults to
+// overflow_detection_on so that counting_overflow<ignore_overflow> still detects.
+template <class Policy = ignore_overflow, class Detection = overflow_detection_on>
+struct counting_overflow : public with_detection<Policy, Detection>
+{
+    template <typename L, typename R>
+    static void record_overflow(overflow_operation const operation, overflow_result const detected)
+    {
+        overflow_counters::record(overflow_counters::index_of<L, R>(operation, detected));
+    }
+};
+
+template <class Policy, class Detection>
+struct wraps_on_overflow<counting_overflow<Policy, Detection> > : public wraps_on_overflow<Policy> {};
+} // namespace boost
+
+#endif // VERIFIED_INT_COUNTING_HPP
@@ -0,0 +1,222 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_cursor<P> reads a buffer, such as a received message or a memory mapped file,
+// front to back without copying it, checking that every read stays within the buffer.  With
+// the be_field of verified_int_endian.hpp, a length-prefixed message reads as:
+//
+//     verified_cursor<throw_overflow> message(buffer, size);
+//     uint16_t const type = message.read<be_field<uint16_t> >().value();
+//     uint32_t const length = message.read<be_field<uint32_t> >().value();
+//     verified_cursor<throw_overflow> body = message.subspan(length);  // Throws past the end.
+//
+// Lengths and offsets may be of any integer type, as read from the buffer.  Each take, read,
+// skip, subspan and seek converts its length to std::size_t, where a negative length, or one
+// wider than std::size_t, is an assignment overflow, and compares it with the bytes remaining
+// in one comparison, so that offset + length cannot exceed size and cannot wrap.  offset,
+// remaining and size are returned as verified_int<std::size_t, P>, so that arithmetic on them
+// is checked too.
+//
+// A length beyond the end is a positive overflow of the offset, recorded and handled by P.
+// Whatever P returns, and whether or not P detects overflow, the cursor never reads past the
+// end: it moves to the end and is failed, take returns 0, read returns T() and subspan
+// returns an empty failed cursor.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_CURSOR_HPP
+#define VERIFIED_INT_CURSOR_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+
+#if defined(__has_include) && __cplusplus >= 202002L
+#  if __has_include(<span>)
+#    include <span>
+#  endif
+#endif
+
+namespace boost {
+
+template <class P = throw_overflow>
+class verified_cursor
+{
+public:
+    typedef verified_int<std::size_t, P> size_type;
+
+    // An empty cursor.
+    verified_cursor() : first_(0), position_(0), remaining_(0), failed_(false)
+    {
+    }
+
+    verified_cursor(void const *const data, std::size_t const size) :
+        first_(static_cast<unsigned char const *>(data)),
+        position_(static_cast<unsigned char const *>(data)),
+        remaining_(size),
+        failed_(false)
+    {
+    }
+
+#if defined(__cpp_lib_span)
+    explicit verified_cursor(std::span<std::byte const> const bytes) :
+        first_(reinterpret_cast<unsigned char const *>(bytes.data())),
+        position_(reinterpret_cast<unsigned char const *>(bytes.data())),
+        remaining_(bytes.size()),
+        failed_(false)
+    {
+    }
+#endif
+
+    size_type size() const
+    {
+        return verified(static_cast<std::size_t>(position_ - first_) + remaining_);
+    }
+
+    size_type offset() const
+    {
+        return verified(static_cast<std::size_t>(position_ - first_));
+    }
+
+    size_type remaining() const
+    {
+        return verified(remaining_);
+    }
+
+    bool empty() const
+    {
+        return remaining_ == 0;
+    }
+
+    // Whether a length beyond the end has been given.
+    bool failed() const
+    {
+        return failed_;
+    }
+
+    // The next byte.
+    unsigned char const *data() const
+    {
+        return position_;
+    }
+
+    // Returns the next count bytes and moves past them.
+    template <typename L>
+    unsigned char const *take(L const count)
+    {
+        std::size_t length;
+        if (!reserve(count, length)) {
+            return 0;
+        }
+        unsigned char const *const bytes = position_;
+        advance(length);
+        return bytes;
+    }
+
+    // Copies the next sizeof(T) bytes into a T, such as an integer, a be_field or a record of
+    // them, and moves past them.
+    template <typename T>
+    T read()
+    {
+        T value = T();
+        std::size_t length;
+        if (reserve(sizeof(T), length)) {
+            std::memcpy(&value, position_, sizeof(T));
+            advance(sizeof(T));
+        }
+        return value;
+    }
+
+    template <typename L>
+    void skip(L const count)
+    {
+        take(count);
+    }
+
+    // A cursor over the next count bytes, which this cursor moves past.
+    template <typename L>
+    verified_cursor subspan(L const count)
+    {
+        std::size_t length;
+        if (!reserve(count, length)) {
+            verified_cursor empty_cursor;
+            empty_cursor.failed_ = true;
+            return empty_cursor;
+        }
+        verified_cursor const body(position_, length);
+        advance(length);
+        return body;
+    }
+
+    // Moves to offset bytes from the beginning of the buffer, which may be before the cursor.
+    template <typename L>
+    void seek(L const offset)
+    {
+        std::size_t const consumed = static_cast<std::size_t>(position_ - first_);
+        position_ = first_;
+        remaining_ += consumed;
+        take(offset);
+    }
+
+private:
+    // verified_int converts from the fixed width types, and std::size_t is not the same type
+    // as uint64_t on every platform.
+    static size_type verified(std::size_t const value)
+    {
+        return size_type(static_cast<uint64_t>(value));
+    }
+
+    // Converts count to length, and checks that length bytes remain.  Otherwise moves to the
+    // end and lets P handle the length.
+    template <typename L>
+    bool reserve(L const count, std::size_t &length)
+    {
+        checked_result<std::size_t> const converted = checked_convert<std::size_t>(count);
+        length = converted.value;
+        if (converted.result != e_no_overflow_detected) {
+            fail();
+            handle(e_assignment_operation, converted.result, length);
+            return false;
+        }
+        if (length > remaining_) {
+            fail();
+            handle(e_addition_operation, e_positive_overflow_detected, length);
+            return false;
+        }
+        return true;
+    }
+
+    void advance(std::size_t const length)
+    {
+        position_ += length;
+        remaining_ -= length;
+    }
+
+    void fail()
+    {
+        position_ += remaining_;
+        remaining_ = 0;
+        failed_ = true;
+    }
+
+    // Static, so that the cursor can stay in registers around the call.
+    static BOOST_NOINLINE void handle(overflow_operation const operation, overflow_result const detected,
+                                      std::size_t const length)
+    {
+        P::template record_overflow<std::size_t, std::size_t>(operation, detected);
+        P::handle_overflow(length, detected);
+    }
+
+    unsigned char const *first_;
+    unsigned char const *position_;
+    std::size_t remaining_;
+    bool failed_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_CURSOR_HPP
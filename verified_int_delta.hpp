@@ -0,0 +1,427 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Delta and delta-of-delta codecs for columns of T, such as sorted timestamps and IDs,
+// which reconstruct the column with its overflow verified by P:
+//
+//     delta_encoder<int64_t, throw_overflow> encoder;
+//     encoder.encode(deltas, timestamps, count);
+//
+//     delta_decoder<int64_t, throw_overflow> decoder;
+//     while (...) {
+//         decoder.decode(block, deltas, block_count);  // Continues from the previous block.
+//     }
+//
+// Encoders and decoders keep the last value between calls, so that a column is encoded
+// and decoded block by block.  The first value is a delta from start, which is zero by
+// default.  A decoded value is the previous value plus its delta, and every overflow of it
+// is detected and handled by P exactly as verified_int<T, P> += delta would, so that
+// corrupted deltas cannot silently wrap the column.  The deltas themselves are T, and a
+// delta out of the range of T is handled by P when encoding.  decode_run decodes a run of
+// equal deltas, checking only its last value.  The delta-of-delta codecs apply a delta
+// codec to the deltas of the column, which are themselves verified by P, so that a
+// column with a constant stride encodes as zeros.  They require signed T.
+//
+// Each block of a column is decoded with a prefix sum which does not branch on overflow.
+// For T narrower than 64 bits, it is computed sixteen bytes at a time with SSE2 where the
+// compiler targets it.  Only a block which overflowed is decoded again with
+// verified_int<T, P>.  When P throws, the values of that block are unspecified and the
+// decoder continues from the previous block.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_DELTA_HPP
+#define VERIFIED_INT_DELTA_HPP
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+#include "verified_int_overflow_detection.hpp"
+#include "verified_int_simd.hpp"
+
+namespace boost {
+
+// ***********************************************
+// Wrapped overflow
+// ***********************************************
+// Whether result, the wrapped left + right or left - right, overflowed T.  Bitwise, so that
+// a loop of them does not branch.
+template <typename T, bool is_signed_type = is_signed<T>::value>
+struct wrapped_overflow
+{
+    static bool addition(T const left, T const right, T const result)
+    {
+        return sign_of<T>::is_negative(static_cast<T>((result ^ left) & (result ^ right)));
+    }
+    static bool subtraction(T const left, T const right, T const result)
+    {
+        return sign_of<T>::is_negative(static_cast<T>((left ^ result) & (left ^ right)));
+    }
+};
+
+template <typename T>
+struct wrapped_overflow<T, false>
+{
+    static bool addition(T const left, T const right, T const result)
+    {
+        (void)right;
+        return result < left;
+    }
+    static bool subtraction(T const left, T const right, T const result)
+    {
+        (void)result;
+        return right > left;
+    }
+};
+
+// Sets result to the wrapped left + right, returning whether it overflowed.
+template <typename T>
+inline bool add_wrapped(T &result, T const left, T const right)
+{
+#if defined(BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS)
+    return __builtin_add_overflow(left, right, &result);
+#else
+    result = wrapped_arithmetic<T>::add(left, right);
+    return wrapped_overflow<T>::addition(left, right, result);
+#endif
+}
+
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+// ***********************************************
+// Lanes
+// ***********************************************
+// Prefix sums of lanes of Size bytes in an SSE2 register.
+template <std::size_t Size>
+struct delta_lanes;
+
+template <>
+struct delta_lanes<1>
+{
+    // The bits of _mm_movemask_epi8 of the highest byte of each lane.
+    static int const sign_bits = 0xFFFF;
+    static __m128i add(__m128i const left, __m128i const right) { return _mm_add_epi8(left, right); }
+    static __m128i subtract(__m128i const left, __m128i const right) { return _mm_sub_epi8(left, right); }
+    static __m128i scan(__m128i lanes)
+    {
+        lanes = _mm_add_epi8(lanes, _mm_slli_si128(lanes, 1));
+        lanes = _mm_add_epi8(lanes, _mm_slli_si128(lanes, 2));
+        lanes = _mm_add_epi8(lanes, _mm_slli_si128(lanes, 4));
+        return _mm_add_epi8(lanes, _mm_slli_si128(lanes, 8));
+    }
+    static __m128i broadcast_last(__m128i const lanes)
+    {
+        __m128i const pairs = _mm_unpackhi_epi8(lanes, lanes);
+        return _mm_shuffle_epi32(_mm_shufflehi_epi16(pairs, 0xFF), 0xFF);
+    }
+};
+
+template <>
+struct delta_lanes<2>
+{
+    static int const sign_bits = 0xAAAA;
+    static __m128i add(__m128i const left, __m128i const right) { return _mm_add_epi16(left, right); }
+    static __m128i subtract(__m128i const left, __m128i const right) { return _mm_sub_epi16(left, right); }
+    static __m128i scan(__m128i lanes)
+    {
+        lanes = _mm_add_epi16(lanes, _mm_slli_si128(lanes, 2));
+        lanes = _mm_add_epi16(lanes, _mm_slli_si128(lanes, 4));
+        return _mm_add_epi16(lanes, _mm_slli_si128(lanes, 8));
+    }
+    static __m128i broadcast_last(__m128i const lanes)
+    {
+        return _mm_shuffle_epi32(_mm_shufflehi_epi16(lanes, 0xFF), 0xFF);
+    }
+};
+
+template <>
+struct delta_lanes<4>
+{
+    static int const sign_bits = 0x8888;
+    static __m128i add(__m128i const left, __m128i const right) { return _mm_add_epi32(left, right); }
+    static __m128i subtract(__m128i const left, __m128i const right) { return _mm_sub_epi32(left, right); }
+    static __m128i scan(__m128i lanes)
+    {
+        lanes = _mm_add_epi32(lanes, _mm_slli_si128(lanes, 4));
+        return _mm_add_epi32(lanes, _mm_slli_si128(lanes, 8));
+    }
+    static __m128i broadcast_last(__m128i const lanes) { return _mm_shuffle_epi32(lanes, 0xFF); }
+};
+
+template <>
+struct delta_lanes<8>
+{
+    static int const sign_bits = 0x8080;
+    static __m128i add(__m128i const left, __m128i const right) { return _mm_add_epi64(left, right); }
+    static __m128i subtract(__m128i const left, __m128i const right) { return _mm_sub_epi64(left, right); }
+    static __m128i scan(__m128i const lanes) { return _mm_add_epi64(lanes, _mm_slli_si128(lanes, 8)); }
+    static __m128i broadcast_last(__m128i const lanes) { return _mm_shuffle_epi32(lanes, 0xEE); }
+};
+
+// The sign bit of each lane is set where after, the wrapped before + delta, overflowed.
+template <bool is_signed_type>
+inline __m128i lanes_overflowed(__m128i const before, __m128i const delta, __m128i const after)
+{
+    return _mm_and_si128(_mm_xor_si128(after, before), _mm_xor_si128(after, delta));
+}
+
+// The carry out of each lane.
+template <>
+inline __m128i lanes_overflowed<false>(__m128i const before, __m128i const delta, __m128i const after)
+{
+    return _mm_or_si128(_mm_and_si128(before, delta), _mm_andnot_si128(after, _mm_or_si128(before, delta)));
+}
+#endif
+
+// ***********************************************
+// Delta codec
+// ***********************************************
+template <typename T, class P>
+class delta_encoder
+{
+public:
+    typedef verified_int<T, P> value_type;
+    typedef typename P::template detection<T, T>::type detection_type;
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+    static std::size_t const block_size = 256;
+
+    explicit delta_encoder(value_type const start = value_type())
+        : previous_(static_cast<T>(start))
+    {}
+
+    // The last value encoded.
+    value_type previous() const
+    {
+        return value_type(previous_);
+    }
+
+    // Writes the delta of each of count values from the value before it.
+    void encode(T *const deltas, T const *const values, std::size_t const count)
+    {
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            T const first = values[begin];
+            deltas[begin] = wrapped_arithmetic<T>::subtract(first, previous_);
+            bool overflowed = wrapped_overflow<T>::subtraction(first, previous_, deltas[begin]);
+            // The deltas are independent, so the loop vectorizes.
+            for (std::size_t index = begin + 1; index < begin + size; ++index) {
+                T const delta = wrapped_arithmetic<T>::subtract(values[index], values[index - 1]);
+                overflowed |= wrapped_overflow<T>::subtraction(values[index], values[index - 1], delta);
+                deltas[index] = delta;
+            }
+            if (is_detecting && overflowed) {
+                replay(deltas + begin, values + begin, size);
+            }
+            previous_ = values[begin + size - 1];
+        }
+    }
+
+private:
+    BOOST_NOINLINE void replay(T *const deltas, T const *const values, std::size_t const count) const
+    {
+        T before = previous_;
+        for (std::size_t index = 0; index < count; ++index) {
+            deltas[index] = static_cast<T>(value_type(values[index]) - before);
+            before = values[index];
+        }
+    }
+
+    T previous_;
+};
+
+template <typename T, class P>
+class delta_decoder
+{
+public:
+    typedef verified_int<T, P> value_type;
+    typedef typename P::template detection<T, T>::type detection_type;
+    typedef typename make_unsigned<T>::type magnitude_type;
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+    static std::size_t const block_size = 256;
+
+    explicit delta_decoder(value_type const start = value_type())
+        : previous_(static_cast<T>(start))
+    {}
+
+    // The last value decoded.
+    value_type previous() const
+    {
+        return value_type(previous_);
+    }
+
+    // Writes each of count values, the value before it plus its delta.
+    void decode(T *const values, T const *const deltas, std::size_t const count)
+    {
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            T running = previous_;
+            if (decode_block(running, values + begin, deltas + begin, size) || !is_detecting) {
+                previous_ = running;
+            } else {
+                replay(values + begin, deltas + begin, size);
+            }
+        }
+    }
+
+    // Writes count values, each delta more than the value before it.
+    void decode_run(T *const values, T const delta, std::size_t const count)
+    {
+        // The values are monotonic, so only the last can be the first to overflow.
+        bool const is_rising = !sign_of<T>::is_negative(delta);
+        magnitude_type const room = is_rising
+            ? static_cast<magnitude_type>(static_cast<magnitude_type>(integer_traits<T>::const_max) -
+                                          static_cast<magnitude_type>(previous_))
+            : static_cast<magnitude_type>(static_cast<magnitude_type>(previous_) -
+                                          static_cast<magnitude_type>(integer_traits<T>::const_min));
+        magnitude_type const step = is_rising ? static_cast<magnitude_type>(delta)
+                                              : static_cast<magnitude_type>(0 - static_cast<magnitude_type>(delta));
+        if (is_detecting && step != 0 && count > room / step) {
+            std::size_t begin = 0;
+            for (; begin < count; begin += block_size) {
+                std::size_t const size = count - begin < block_size ? count - begin : block_size;
+                T repeated[block_size];
+                for (std::size_t index = 0; index < size; ++index) {
+                    repeated[index] = delta;
+                }
+                replay(values + begin, repeated, size);
+            }
+            return;
+        }
+        T running = previous_;
+        for (std::size_t index = 0; index < count; ++index) {
+            running = wrapped_arithmetic<T>::add(running, delta);
+            values[index] = running;
+        }
+        previous_ = running;
+    }
+
+private:
+    // Decodes count values without branching on overflow, returning whether none
+    // overflowed.
+    static bool decode_block(T &running, T *const values, T const *const deltas, std::size_t const count)
+    {
+        std::size_t index = 0;
+        bool overflowed = false;
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+        typedef delta_lanes<sizeof(T)> lanes;
+        std::size_t const lane_count = 16 / sizeof(T);
+        // Two lanes of 64 bits are slower than the flags of scalar additions.
+        if (sizeof(T) < 8 && count >= lane_count) {
+            T repeated[lane_count];
+            for (std::size_t lane = 0; lane < lane_count; ++lane) {
+                repeated[lane] = running;
+            }
+            __m128i previous = _mm_loadu_si128(reinterpret_cast<__m128i const *>(repeated));
+            __m128i overflowed_lanes = _mm_setzero_si128();
+            for (; index + lane_count <= count; index += lane_count) {
+                __m128i const delta = _mm_loadu_si128(reinterpret_cast<__m128i const *>(deltas + index));
+                __m128i const sums = lanes::scan(delta);
+                __m128i const after = lanes::add(sums, previous);
+                __m128i const before = lanes::subtract(after, delta);
+                overflowed_lanes = _mm_or_si128(overflowed_lanes,
+                                                lanes_overflowed<is_signed<T>::value>(before, delta, after));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(values + index), after);
+                // Only the addition depends on the previous lanes.
+                previous = lanes::add(previous, lanes::broadcast_last(sums));
+            }
+            overflowed = (_mm_movemask_epi8(overflowed_lanes) & lanes::sign_bits) != 0;
+            running = values[index - 1];
+        }
+#endif
+        for (; index < count; ++index) {
+            overflowed |= add_wrapped(running, running, deltas[index]);
+            values[index] = running;
+        }
+        return !overflowed;
+    }
+
+    BOOST_NOINLINE void replay(T *const values, T const *const deltas, std::size_t const count)
+    {
+        value_type running(previous_);
+        for (std::size_t index = 0; index < count; ++index) {
+            running += deltas[index];
+            values[index] = static_cast<T>(running);
+        }
+        previous_ = static_cast<T>(running);
+    }
+
+    T previous_;
+};
+
+// ***********************************************
+// Delta-of-delta codec
+// ***********************************************
+template <typename T, class P>
+class delta_of_delta_encoder
+{
+    BOOST_STATIC_ASSERT_MSG(is_signed<T>::value, "deltas of deltas are signed");
+
+public:
+    typedef verified_int<T, P> value_type;
+    static std::size_t const block_size = delta_encoder<T, P>::block_size;
+
+    explicit delta_of_delta_encoder(value_type const start = value_type())
+        : values_(start)
+    {}
+
+    // Writes the change in delta of each of count values.
+    void encode(T *const deltas_of_deltas, T const *const values, std::size_t const count)
+    {
+        T deltas[block_size];
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            values_.encode(deltas, values + begin, size);
+            deltas_.encode(deltas_of_deltas + begin, deltas, size);
+        }
+    }
+
+private:
+    delta_encoder<T, P> values_;
+    delta_encoder<T, P> deltas_;
+};
+
+template <typename T, class P>
+class delta_of_delta_decoder
+{
+    BOOST_STATIC_ASSERT_MSG(is_signed<T>::value, "deltas of deltas are signed");
+
+public:
+    typedef verified_int<T, P> value_type;
+    static std::size_t const block_size = delta_decoder<T, P>::block_size;
+
+    explicit delta_of_delta_decoder(value_type const start = value_type())
+        : values_(start)
+    {}
+
+    // The last value decoded.
+    value_type previous() const
+    {
+        return values_.previous();
+    }
+
+    // Writes each of count values, reconstructing both the deltas and the values with P.
+    void decode(T *const values, T const *const deltas_of_deltas, std::size_t const count)
+    {
+        T deltas[block_size];
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            deltas_.decode(deltas, deltas_of_deltas + begin, size);
+            values_.decode(values + begin, deltas, size);
+        }
+    }
+
+private:
+    delta_decoder<T, P> deltas_;
+    delta_decoder<T, P> values_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_DELTA_HPP
@@ -0,0 +1,112 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Writes verified_int<T, P> to a std::ostream, and to std::format where the standard library
+// provides it, with verified_to_chars:
+//
+//     std::clog << "requests " << requests << '\n';
+//     std::string const line = std::format("requests {}", requests);
+//
+// Decimal output, without showpos or a field width, is written from a buffer on the stack,
+// without allocating and without the locale of the stream.  Other flags, and format
+// specifications other than {}, are formatted as a built-in would be.  8-bit integers are
+// written as numbers rather than as characters.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_IO_HPP
+#define VERIFIED_INT_IO_HPP
+
+#include <algorithm>
+#include <ios>
+#include <ostream>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include "verified_int.hpp"
+#include "verified_int_charconv.hpp"
+
+#if defined(__has_include) && __cplusplus >= 202002L
+#  if __has_include(<format>)
+#    include <format>
+#  endif
+#endif
+
+namespace boost {
+
+// The type a T is streamed as.  8-bit integers are widened, so that they are written as
+// numbers rather than as characters, and every other T is written as itself.
+template <typename T>
+struct verified_stream_type
+{
+    typedef T type;
+};
+
+template <>
+struct verified_stream_type<int8_t>
+{
+    typedef int type;
+};
+
+template <>
+struct verified_stream_type<uint8_t>
+{
+    typedef unsigned int type;
+};
+
+template <typename T, class P>
+inline std::ostream &operator<<(std::ostream &out, verified_int<T, P> const &value)
+{
+    std::ios_base::fmtflags const base = out.flags() & std::ios_base::basefield;
+    bool const is_decimal = base != std::ios_base::oct && base != std::ios_base::hex;
+    if (is_decimal && !(out.flags() & std::ios_base::showpos) && out.width() == 0) {
+        char buffer[verified_chars<T>::size];
+        char *const end = verified_to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        out.write(buffer, end - buffer);
+        return out;
+    }
+    if (is_decimal) {
+        out << static_cast<typename verified_stream_type<T>::type>(static_cast<T>(value));
+    } else {
+        // Octal and hexadecimal write the bits of T, so an int8_t of -1 is ff as for T.
+        typedef typename make_unsigned<T>::type unsigned_type;
+        out << static_cast<typename verified_stream_type<unsigned_type>::type>(
+            static_cast<unsigned_type>(static_cast<T>(value)));
+    }
+    return out;
+}
+} // namespace boost
+
+#if defined(__cpp_lib_format)
+namespace std {
+
+// {} is written with verified_to_chars, and any other specification as T would be.
+template <typename T, class P>
+struct formatter<boost::verified_int<T, P>, char> : public formatter<T, char>
+{
+    bool is_default = true;
+
+    template <class ParseContext>
+    constexpr typename ParseContext::iterator parse(ParseContext &context)
+    {
+        is_default = context.begin() == context.end() || *context.begin() == '}';
+        return formatter<T, char>::parse(context);
+    }
+
+    template <class FormatContext>
+    typename FormatContext::iterator format(boost::verified_int<T, P> const &value, FormatContext &context) const
+    {
+        if (!is_default) {
+            return formatter<T, char>::format(static_cast<T>(value), context);
+        }
+        char buffer[boost::verified_chars<T>::size];
+        char *const end = boost::verified_to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        return std::copy(buffer, end, context.out());
+    }
+};
+} // namespace std
+#endif
+
+#endif // VERIFIED_INT_IO_HPP
@@ -0,0 +1,248 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_layout<Index, Rank, P> maps the indices of a multi-dimensional array, such as an
+// image tile or a tensor, to the offset of the element, as the layout mappings of mdspan do:
+//
+//     int32_t const extents[] = { depth, height, width };
+//     verified_layout<int32_t, 3> const layout(extents);   // Throws if it overflows int32_t.
+//     float const value = data[layout(k, j, i)];           // k * stride0 + j * stride1 + i
+//
+// The strides of a row major or column major layout, and the required span size, one past
+// the largest offset, are computed with checked_mul and checked_add once, when the layout is
+// constructed.  Every offset of indices within the extents is at most the required span size,
+// and every partial sum of the offset is too, so mapping the indices needs no checks: it is
+// the multiplications and additions in Index of an unchecked layout.  The indices must be
+// within the extents, as for mdspan, and are not checked.
+//
+// A negative extent or stride, and a stride or required span size which overflows Index, are
+// recorded and handled by P.  If P returns, the layout is failed and empty, with every extent,
+// stride and the required span size 0, so that no indices are within it.  The extents,
+// strides and required span size are returned as verified_int<Index, P>, so that arithmetic
+// on them is checked too.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_LAYOUT_HPP
+#define VERIFIED_INT_LAYOUT_HPP
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+
+namespace boost {
+
+// Index is a fixed width integer type.
+template <typename Index, std::size_t Rank, class P = throw_overflow>
+class verified_layout
+{
+    BOOST_STATIC_ASSERT(Rank > 0);
+
+public:
+    typedef verified_int<Index, P> index_type;
+
+    // An empty layout.
+    verified_layout() : required_span_size_(0), failed_(false)
+    {
+        clear();
+    }
+
+    // A row major layout, where the last index is contiguous, as layout_right.
+    explicit verified_layout(Index const (&extents)[Rank]) : required_span_size_(0), failed_(false)
+    {
+        if (assign(extents) && pack(false)) {
+            span();
+        }
+    }
+
+    // A layout with the given strides, as layout_stride.
+    verified_layout(Index const (&extents)[Rank], Index const (&strides)[Rank]) :
+        required_span_size_(0),
+        failed_(false)
+    {
+        if (assign(extents) && assign_strides(strides)) {
+            span();
+        }
+    }
+
+    // A column major layout, where the first index is contiguous, as layout_left.
+    static verified_layout column_major(Index const (&extents)[Rank])
+    {
+        verified_layout layout;
+        if (layout.assign(extents) && layout.pack(true)) {
+            layout.span();
+        }
+        return layout;
+    }
+
+    static BOOST_CONSTEXPR std::size_t rank()
+    {
+        return Rank;
+    }
+
+    index_type extent(std::size_t const dimension) const
+    {
+        return index_type(extents_[dimension]);
+    }
+
+    index_type stride(std::size_t const dimension) const
+    {
+        return index_type(strides_[dimension]);
+    }
+
+    // One past the largest offset, or 0 if an extent is 0.
+    index_type required_span_size() const
+    {
+        return index_type(required_span_size_);
+    }
+
+    // Whether the extents or strides have overflowed.
+    bool failed() const
+    {
+        return failed_;
+    }
+
+    // The offset of the element at indices, which are within the extents.
+    Index operator()(Index const (&indices)[Rank]) const
+    {
+        Index offset = 0;
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            offset = static_cast<Index>(offset + indices[dimension] * strides_[dimension]);
+        }
+        return offset;
+    }
+
+    Index operator()(Index const i0) const
+    {
+        BOOST_STATIC_ASSERT(Rank == 1);
+        return static_cast<Index>(i0 * strides_[0]);
+    }
+
+    Index operator()(Index const i0, Index const i1) const
+    {
+        BOOST_STATIC_ASSERT(Rank == 2);
+        return static_cast<Index>(i0 * strides_[0] + i1 * strides_[1]);
+    }
+
+    Index operator()(Index const i0, Index const i1, Index const i2) const
+    {
+        BOOST_STATIC_ASSERT(Rank == 3);
+        return static_cast<Index>(i0 * strides_[0] + i1 * strides_[1] + i2 * strides_[2]);
+    }
+
+    Index operator()(Index const i0, Index const i1, Index const i2, Index const i3) const
+    {
+        BOOST_STATIC_ASSERT(Rank == 4);
+        return static_cast<Index>(i0 * strides_[0] + i1 * strides_[1] + i2 * strides_[2] + i3 * strides_[3]);
+    }
+
+private:
+    typedef typename make_unsigned<Index>::type unsigned_index;
+
+    // Copies the extents, which must not be negative.
+    bool assign(Index const (&extents)[Rank])
+    {
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            extents_[dimension] = extents[dimension];
+        }
+        return nonnegative(extents_);
+    }
+
+    bool assign_strides(Index const (&strides)[Rank])
+    {
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            strides_[dimension] = strides[dimension];
+        }
+        return nonnegative(strides_);
+    }
+
+    // Converting to the unsigned Index detects a negative value.
+    bool nonnegative(Index const (&values)[Rank])
+    {
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            checked_result<unsigned_index> const converted = checked_convert<unsigned_index>(values[dimension]);
+            if (converted.result != e_no_overflow_detected) {
+                fail(e_assignment_operation, converted.result, values[dimension]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Sets the stride of each dimension to the product of the extents of the dimensions after
+    // it, or before it for column major.  The product of every extent is checked too.
+    bool pack(bool const column_major)
+    {
+        Index stride = 1;
+        for (std::size_t order = 0; order != Rank; ++order) {
+            std::size_t const dimension = column_major ? order : Rank - 1 - order;
+            strides_[dimension] = stride;
+            checked_result<Index> const product = checked_mul(stride, extents_[dimension]);
+            if (product.result != e_no_overflow_detected) {
+                fail(e_multiplication_operation, product.result, product.value);
+                return false;
+            }
+            stride = product.value;
+        }
+        return true;
+    }
+
+    // Computes 1 + the sum of (extent - 1) * stride, the largest offset + 1.
+    void span()
+    {
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            if (extents_[dimension] == 0) {
+                required_span_size_ = 0;
+                return;
+            }
+        }
+        Index size = 1;
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            checked_result<Index> const term = checked_mul(static_cast<Index>(extents_[dimension] - 1),
+                                                           strides_[dimension]);
+            if (term.result != e_no_overflow_detected) {
+                fail(e_multiplication_operation, term.result, term.value);
+                return;
+            }
+            checked_result<Index> const sum = checked_add(size, term.value);
+            if (sum.result != e_no_overflow_detected) {
+                fail(e_addition_operation, sum.result, sum.value);
+                return;
+            }
+            size = sum.value;
+        }
+        required_span_size_ = size;
+    }
+
+    void clear()
+    {
+        for (std::size_t dimension = 0; dimension != Rank; ++dimension) {
+            extents_[dimension] = 0;
+            strides_[dimension] = 0;
+        }
+        required_span_size_ = 0;
+    }
+
+    // Empties the layout and lets P handle the overflow.
+    void fail(overflow_operation const operation, overflow_result const detected, Index const value)
+    {
+        clear();
+        failed_ = true;
+        P::template record_overflow<Index, Index>(operation, detected);
+        P::handle_overflow(value, detected);
+    }
+
+    Index extents_[Rank];
+    Index strides_[Rank];
+    Index required_span_size_;
+    bool failed_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_LAYOUT_HPP
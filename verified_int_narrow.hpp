@@ -0,0 +1,226 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_narrow<T, P> converts a buffer of integers to T, handling each element exactly
+// as verified_int<T, P>(source[i]) does, without a branch per element:
+//
+//     verified_narrow<int16_t, throw_overflow>(samples, decoded, count);
+//
+// Each block of elements is converted and checked for overflow without branching, and only
+// a block containing an overflow is converted again element by element with P.  When P
+// throws, the exception carries the index of the first offending element as overflow_index:
+//
+//     catch (boost::overflow_detected const & e) {
+//         std::size_t const *const index = boost::get_error_info<boost::overflow_index>(e);
+//     }
+//
+// saturate_overflow uses the saturating packs of SSE2 from 16 and 32-bit signed elements to
+// 8 and 16-bit elements.  A second overload appends the indices of the offending elements to
+// a vector instead of relying on P to report them.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_NARROW_HPP
+#define VERIFIED_INT_NARROW_HPP
+
+#include <cstddef>
+#include <vector>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/exception/info.hpp>
+#include <boost/exception/exception.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int_policies.hpp"
+#include "verified_int_overflow_detection.hpp"
+#include "verified_int_simd.hpp"
+
+namespace boost {
+
+// Index of the element which overflowed, attached to the exceptions thrown by verified_narrow.
+typedef error_info<struct tag_overflow_index, std::size_t> overflow_index;
+
+// Saturating conversion of whole registers from U to T, when SSE2 has a pack for them.
+template <typename U, typename T>
+struct simd_pack
+{
+    // Elements converted by each apply, zero when there is no pack.
+    static std::size_t const size = 0;
+    static void apply(T *const, U const *const) {}
+};
+
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+#define GEN_SIMD_PACK16(TYPE, PACK) \
+    template <> \
+    struct simd_pack<int16_t, TYPE> \
+    { \
+        static std::size_t const size = 16; \
+        static void apply(TYPE *const destination, int16_t const *const source) { \
+            __m128i const low = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source)); \
+            __m128i const high = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + 8)); \
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), PACK(low, high)); \
+        } \
+    };
+GEN_SIMD_PACK16(int8_t, _mm_packs_epi16)
+GEN_SIMD_PACK16(uint8_t, _mm_packus_epi16)
+#undef GEN_SIMD_PACK16
+
+template <>
+struct simd_pack<int32_t, int16_t>
+{
+    static std::size_t const size = 8;
+    static void apply(int16_t *const destination, int32_t const *const source) {
+        __m128i const low = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source));
+        __m128i const high = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), _mm_packs_epi32(low, high));
+    }
+};
+
+// Saturating to int16_t first does not change the result of saturating to 8 bits.
+#define GEN_SIMD_PACK32(TYPE, PACK) \
+    template <> \
+    struct simd_pack<int32_t, TYPE> \
+    { \
+        static std::size_t const size = 16; \
+        static void apply(TYPE *const destination, int32_t const *const source) { \
+            __m128i const *const registers = reinterpret_cast<__m128i const *>(source); \
+            __m128i const low = _mm_packs_epi32(_mm_loadu_si128(registers), _mm_loadu_si128(registers + 1)); \
+            __m128i const high = _mm_packs_epi32(_mm_loadu_si128(registers + 2), _mm_loadu_si128(registers + 3)); \
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), PACK(low, high)); \
+        } \
+    };
+GEN_SIMD_PACK32(int8_t, _mm_packs_epi16)
+GEN_SIMD_PACK32(uint8_t, _mm_packus_epi16)
+#undef GEN_SIMD_PACK32
+#endif
+
+template <typename T, class P, typename U>
+struct narrow_buffer
+{
+    typedef typename P::template detection<T, U>::type detection_type;
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, U> >::value;
+    // Elements converted before checking for overflow.
+    static std::size_t const block_size = 64;
+
+    // A value is out of range when it does not survive the round trip through T, or when
+    // its sign changes.  The sign can only change between types of different signedness.
+    static bool const is_sign_lost = is_signed<U>::value && !is_signed<T>::value;
+    static bool const is_sign_gained = !is_signed<U>::value && is_signed<T>::value;
+
+    // Converts count elements, returning whether any of them overflowed.  The differences
+    // and signs are accumulated with bitwise ors, so that the loop vectorizes.
+    static bool convert(T *const destination, U const *const source, std::size_t const count)
+    {
+        U differences = 0;
+        U signs_lost = 0;
+        T signs_gained = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            U const value = source[index];
+            T const narrowed = static_cast<T>(value);
+            differences |= value ^ static_cast<U>(narrowed);
+            signs_lost |= value;
+            signs_gained |= narrowed;
+            destination[index] = narrowed;
+        }
+        return is_detecting && (differences != 0 ||
+                                (is_sign_lost && sign_of<U>::is_negative(signs_lost)) ||
+                                (is_sign_gained && sign_of<T>::is_negative(signs_gained)));
+    }
+
+    // Lets P handle each offending element in [begin, end), attaching the index of the
+    // element to anything P throws.
+    static BOOST_NOINLINE void handle(T *const destination, U const *const source,
+                                      std::size_t const begin, std::size_t const end,
+                                      std::vector<std::size_t> *const offending)
+    {
+        for (std::size_t index = begin; index < end; ++index) {
+            overflow_result const detected = detection_type::detect_overflow_assignment(source[index]);
+            P::template record_overflow<T, U>(e_assignment_operation, detected);
+            if (detected == e_no_overflow_detected) {
+                continue;
+            }
+            if (offending) {
+                offending->push_back(index);
+            }
+            BOOST_TRY {
+                destination[index] = P::handle_overflow(destination[index], detected);
+            }
+            BOOST_CATCH (exception & thrown) {
+                thrown << overflow_index(index);
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+        }
+    }
+
+    static void apply(T *const destination, U const *const source, std::size_t const count,
+                      std::vector<std::size_t> *const offending)
+    {
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            // Whole blocks have a constant trip count.
+            bool const overflowed = count - begin >= block_size
+                ? convert(destination + begin, source + begin, block_size)
+                : convert(destination + begin, source + begin, count - begin);
+            if (overflowed) {
+                std::size_t const end = count - begin > block_size ? begin + block_size : count;
+                handle(destination, source, begin, end, offending);
+            }
+        }
+    }
+
+    // saturate_overflow clamps, which is exactly what the saturating packs compute.
+    static void saturate(T *const destination, U const *const source, std::size_t const count)
+    {
+        std::size_t index = 0;
+        if (simd_pack<U, T>::size != 0) {
+            for (; count - index >= simd_pack<U, T>::size; index += simd_pack<U, T>::size) {
+                simd_pack<U, T>::apply(destination + index, source + index);
+            }
+        }
+        apply(destination + index, source + index, count - index, 0);
+    }
+};
+
+template <typename T, class P, typename U>
+struct narrow_dispatch
+{
+    static void apply(T *const destination, U const *const source, std::size_t const count)
+    {
+        narrow_buffer<T, P, U>::apply(destination, source, count, 0);
+    }
+};
+
+template <typename T, typename U>
+struct narrow_dispatch<T, saturate_overflow, U>
+{
+    static void apply(T *const destination, U const *const source, std::size_t const count)
+    {
+        narrow_buffer<T, saturate_overflow, U>::saturate(destination, source, count);
+    }
+};
+
+// destination[i] = verified_int<T, P>(source[i]) for each of count elements.  When P throws,
+// the elements before the offending one have been converted, and some after it may have been.
+template <typename T, class P, typename U>
+inline void verified_narrow(T *const destination, U const *const source, std::size_t const count)
+{
+    narrow_dispatch<T, P, U>::apply(destination, source, count);
+}
+
+// As above, and appends the index of each offending element to offending, returning the
+// number of indices appended.  Offending elements are those detected by P, so use
+// with_detection<ignore_overflow, overflow_detection_on> to wrap and report.
+template <typename T, class P, typename U>
+inline std::size_t verified_narrow(T *const destination, U const *const source, std::size_t const count,
+                                   std::vector<std::size_t> & offending)
+{
+    std::size_t const previous = offending.size();
+    narrow_buffer<T, P, U>::apply(destination, source, count, &offending);
+    return offending.size() - previous;
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_NARROW_HPP
@@ -24,9 +24,27 @@
 #ifndef VERIFIED_INT_OVERFLOW_DETECTION_HPP
 #define VERIFIED_INT_OVERFLOW_DETECTION_HPP
 
+#include <cstddef>
+#include <boost/config.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/integer_traits.hpp>
+#include <boost/type_traits/conditional.hpp>
 #include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+
+// GCC 5 and later, and every Clang reporting the builtins, provide checked arithmetic
+// intrinsics that compute the infinitely precise result and report whether it fits
+// in the destination type.  Define BOOST_VERIFIED_INT_NO_INTRINSICS to disable them.
+#if !defined(BOOST_VERIFIED_INT_NO_INTRINSICS)
+#  if defined(__has_builtin)
+#    if __has_builtin(__builtin_add_overflow) && __has_builtin(__builtin_sub_overflow) && \
+        __has_builtin(__builtin_mul_overflow)
+#      define BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS
+#    endif
+#  elif defined(__GNUC__) && (__GNUC__ >= 5)
+#    define BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS
+#  endif
+#endif
 
 namespace boost {
 
@@ -36,21 +54,30 @@ enum overflow_result {
     e_negative_overflow_detected
 };
 
+// The operation whose result was checked, passed to the record_overflow hook of a policy.
+enum overflow_operation {
+    e_assignment_operation = 0,
+    e_addition_operation,
+    e_subtraction_operation,
+    e_multiplication_operation,
+    e_division_operation
+};
+
 template <typename L, typename R>
 struct do_not_detect_overflow {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         return e_no_overflow_detected;
     }
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         return e_no_overflow_detected;
     }
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         return e_no_overflow_detected;
     }
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
         return e_no_overflow_detected;
     }
-    static overflow_result detect_overflow_division(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
         return e_no_overflow_detected;
     }
 };
@@ -85,30 +112,162 @@ template <
 >
 struct detect_overflow_impl_division;
 
+// Avoids comparing an unsigned value against zero.
+template <typename T, bool is_value_signed = is_signed<T>::value>
+struct sign_of {
+    static BOOST_CXX14_CONSTEXPR bool is_negative(T const value) {
+        return value < 0;
+    }
+};
+
+template <typename T>
+struct sign_of<T, false> {
+    static BOOST_CXX14_CONSTEXPR bool is_negative(T const value) {
+        (void)value;
+        return false;
+    }
+};
+
+// Native integer type twice as wide as an operand of the given size, which holds the
+// exact result of any addition, subtraction or multiplication of such operands.
+template <std::size_t operand_size, bool is_wide_signed>
+struct widened_int;
+
+template <> struct widened_int<1, true>  { typedef int32_t type; };
+template <> struct widened_int<1, false> { typedef uint32_t type; };
+template <> struct widened_int<2, true>  { typedef int32_t type; };
+template <> struct widened_int<2, false> { typedef uint32_t type; };
+template <> struct widened_int<4, true>  { typedef int64_t type; };
+template <> struct widened_int<4, false> { typedef uint64_t type; };
+
+// Range checks an exactly computed result against L.  A single unsigned comparison
+// detects the overflow, and an out of range value is negative overflow exactly when its
+// sign bit is set, since zero always lies within the range of L.  The result is computed
+// arithmetically rather than by branching, so loops over it can be vectorized.
+template <typename L, typename W>
+inline BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_range(W const value) {
+    typedef typename make_unsigned<W>::type unsigned_type;
+    unsigned_type const lowest = static_cast<unsigned_type>(static_cast<W>(integer_traits<L>::const_min));
+    unsigned_type const highest = static_cast<unsigned_type>(static_cast<W>(integer_traits<L>::const_max));
+    unsigned_type const is_out_of_range = static_cast<unsigned_type>(static_cast<unsigned_type>(value) - lowest) >
+                                          static_cast<unsigned_type>(highest - lowest);
+    unsigned_type const sign_bit = is_signed<W>::value
+        ? static_cast<unsigned_type>(static_cast<unsigned_type>(value) >> (sizeof(W) * 8 - 1))
+        : 0;
+    return static_cast<overflow_result>(is_out_of_range + (is_out_of_range & sign_bit));
+}
+
+template <typename T>
+inline BOOST_CXX14_CONSTEXPR uint64_t magnitude_of(T const value) {
+    return value < 0 ? uint64_t(0) - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+}
+
+// Number of bits required to represent value.
+inline BOOST_CXX14_CONSTEXPR int bit_width(uint64_t const value) {
+#if defined(__GNUC__)
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+    int width = 0;
+    for (uint64_t remaining = value; remaining != 0; remaining >>= 1) {
+        ++width;
+    }
+    return width;
+#endif
+}
+
+// Full 128 bit product of two 64 bit magnitudes.
+inline BOOST_CXX14_CONSTEXPR uint64_t multiply_magnitudes(uint64_t const left, uint64_t const right, uint64_t & high) {
+#if defined(BOOST_HAS_INT128)
+    boost::uint128_type const product = static_cast<boost::uint128_type>(left) * right;
+    high = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#else
+    uint64_t const mask = 0xFFFFFFFFU;
+    uint64_t const low_low = (left & mask) * (right & mask);
+    uint64_t const high_low = (left >> 32) * (right & mask);
+    uint64_t const low_high = (left & mask) * (right >> 32);
+    uint64_t const high_high = (left >> 32) * (right >> 32);
+    uint64_t const middle = (low_low >> 32) + (high_low & mask) + low_high;
+    high = high_high + (high_low >> 32) + (middle >> 32);
+    return (middle << 32) | (low_low & mask);
+#endif
+}
+
+// Detects overflow of a product of the given magnitudes and sign, which L must be signed
+// to hold when negative.
+template <typename L>
+inline BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_magnitude(uint64_t const left, uint64_t const right, bool const is_negative) {
+    overflow_result result = e_no_overflow_detected;
+    overflow_result const detected = is_negative ? e_negative_overflow_detected : e_positive_overflow_detected;
+    uint64_t const limit = is_negative ? magnitude_of(integer_traits<L>::const_min)
+                                       : static_cast<uint64_t>(integer_traits<L>::const_max);
+#if defined(__GNUC__)
+    // When the limit and one magnitude are known at compile time, as for count * sizeof(T),
+    // the other magnitude is compared with their quotient, which folds to an immediate.
+    if (__builtin_constant_p(limit) && __builtin_constant_p(right) && right != 0) {
+        return left > limit / right ? detected : result;
+    }
+    if (__builtin_constant_p(limit) && __builtin_constant_p(left) && left != 0) {
+        return right > limit / left ? detected : result;
+    }
+#endif
+#if defined(BOOST_HAS_INT128)
+    bool const is_product_small = false;
+#else
+    // The full product takes four multiplications here, so skip it when the magnitudes
+    // together span no more bits than L has value bits, as the product then fits.
+    bool const is_product_small = bit_width(left) + bit_width(right) <= integer_traits<L>::digits;
+#endif
+    if (!is_product_small) {
+        uint64_t high = 0;
+        uint64_t const low = multiply_magnitudes(left, right, high);
+        if (high != 0 || low > limit) {
+            result = detected;
+        }
+    }
+    return result;
+}
+
+template <typename L, typename R>
+struct detect_overflow_impl_widened;
+
 template <typename L, typename R>
 struct do_detect_overflow {
     static bool const is_left_signed = is_signed<L>::value;
     static bool const is_right_signed = is_signed<R>::value;
     static bool const is_left_larger = sizeof(L) > sizeof(R);
     static bool const is_right_larger = sizeof(L) < sizeof(R);
+    static bool const are_operands_narrow = sizeof(L) < sizeof(uint64_t) && sizeof(R) < sizeof(uint64_t);
 
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         return detect_overflow_impl_assignment<L, is_left_signed, is_left_larger,
                                         R, is_right_signed, is_right_larger>::detect_overflow_assignment(right);
     }
-    static overflow_result detect_overflow_addition(L const left, R const right) {
-        return detect_overflow_impl_addition<L, is_left_signed, is_left_larger,
-                                      R, is_right_signed, is_right_larger>::detect_overflow_addition(left, right);
-    }
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
-        return detect_overflow_impl_subtraction<L, is_left_signed, is_left_larger,
-                                         R, is_right_signed, is_right_larger>::detect_overflow_subtraction(left, right);
-    }
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
-        return detect_overflow_impl_multiplication<L, is_left_signed,
-                                      R, is_right_signed>::detect_overflow_multiplication(left, right);
-    }
-    static overflow_result detect_overflow_division(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
+        typedef typename conditional<
+            are_operands_narrow,
+            detect_overflow_impl_widened<L, R>,
+            detect_overflow_impl_addition<L, is_left_signed, is_left_larger, R, is_right_signed, is_right_larger>
+        >::type addition_type;
+        return addition_type::detect_overflow_addition(left, right);
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
+        typedef typename conditional<
+            are_operands_narrow,
+            detect_overflow_impl_widened<L, R>,
+            detect_overflow_impl_subtraction<L, is_left_signed, is_left_larger, R, is_right_signed, is_right_larger>
+        >::type subtraction_type;
+        return subtraction_type::detect_overflow_subtraction(left, right);
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        typedef typename conditional<
+            are_operands_narrow,
+            detect_overflow_impl_widened<L, R>,
+            detect_overflow_impl_multiplication<L, is_left_signed, R, is_right_signed>
+        >::type multiplication_type;
+        return multiplication_type::detect_overflow_multiplication(left, right);
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
         return detect_overflow_impl_division<L, is_left_signed, R, is_right_signed>::detect_overflow_division(left, right);
     }
 };
@@ -119,7 +278,7 @@ template <
     typename R, bool is_right_signed, bool is_right_larger
 >
 struct detect_overflow_impl_assignment {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         (void)right;
         return e_no_overflow_detected;
     }
@@ -130,7 +289,7 @@ struct detect_overflow_impl_assignment<
     L, false, is_left_larger,
     R, false, true
 > {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > integer_traits<L>::const_max) {
             result = e_positive_overflow_detected;
@@ -144,7 +303,7 @@ struct detect_overflow_impl_assignment<
     L, true, is_left_larger,
     R, true, true
 > {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > integer_traits<L>::const_max) {
             result = e_positive_overflow_detected;
@@ -160,7 +319,7 @@ struct detect_overflow_impl_assignment<
     L, false, is_left_larger,
     R, true, false
 > {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right < 0) {
             result = e_negative_overflow_detected;
@@ -174,7 +333,7 @@ struct detect_overflow_impl_assignment<
     L, false, is_left_larger,
     R, true, true
 > {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > integer_traits<L>::const_max) {
             result = e_positive_overflow_detected;
@@ -190,7 +349,7 @@ struct detect_overflow_impl_assignment<
     L, true, false,
     R, false, is_right_larger
 > {
-    static overflow_result detect_overflow_assignment(R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > static_cast<R>(integer_traits<L>::const_max)) {
             result = e_positive_overflow_detected;
@@ -204,7 +363,7 @@ struct detect_overflow_impl_addition<
     L, false, is_left_larger,
     R, false, false
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (static_cast<L>(right) > integer_traits<L>::const_max - left) {
             result = e_positive_overflow_detected;
@@ -218,7 +377,7 @@ struct detect_overflow_impl_addition<
     L, false, is_left_larger,
     R, false, true
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > static_cast<R>(integer_traits<L>::const_max - left)) {
             result = e_positive_overflow_detected;
@@ -232,11 +391,11 @@ struct detect_overflow_impl_addition<
     L, true, false,
     R, true, is_right_larger
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && left > integer_traits<L>::const_max - right) {
             result = e_positive_overflow_detected;
-        } else if (right < 0 && right < integer_traits<L>::const_min - left) {
+        } else if (right < 0 && left < integer_traits<L>::const_min - right) {
             result = e_negative_overflow_detected;
         }
         return result;
@@ -253,7 +412,7 @@ struct detect_overflow_impl_addition<
     L, true, true,
     R, true, is_right_larger
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left >= 0) {
             // Negative overflow is impossible here.  Only check for positive overflow.
@@ -275,11 +434,11 @@ struct detect_overflow_impl_addition<
     L, false, is_left_larger,
     R, true, true
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && right > static_cast<R>(integer_traits<L>::const_max - left)) {
             result = e_positive_overflow_detected;
-        } else if (right < 0 && right < static_cast<R>(integer_traits<L>::const_min - left)) {
+        } else if (right < 0 && right < static_cast<R>(integer_traits<L>::const_min) - static_cast<R>(left)) {
             result = e_negative_overflow_detected;
         }
         return result;
@@ -291,7 +450,7 @@ struct detect_overflow_impl_addition<
     L, false, is_left_larger,
     R, true, false
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && static_cast<L>(right) > integer_traits<L>::const_max - left) {
             result = e_positive_overflow_detected;
@@ -307,9 +466,9 @@ struct detect_overflow_impl_addition<
     L, true, false,
     R, false, is_right_larger
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
-        if (right > static_cast<R>(integer_traits<L>::const_max - left)) {
+        if (right > static_cast<R>(integer_traits<L>::const_max) - static_cast<R>(left)) {
             result = e_positive_overflow_detected;
         }
         return result;
@@ -321,7 +480,7 @@ struct detect_overflow_impl_addition<
     L, true, true,
     R, false, is_right_larger
 > {
-    static overflow_result detect_overflow_addition(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left > 0) {
             if (static_cast<L>(right) > integer_traits<L>::const_max - left) {
@@ -337,7 +496,7 @@ struct detect_overflow_impl_subtraction<
     L, false, is_left_larger,
     R, false, is_right_larger
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left < right + integer_traits<L>::const_min) {
             result = e_negative_overflow_detected;
@@ -351,7 +510,7 @@ struct detect_overflow_impl_subtraction<
     L, true, is_left_larger,
     R, true, is_right_larger
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && left < right + integer_traits<L>::const_min) {
             result = e_negative_overflow_detected;
@@ -367,7 +526,7 @@ struct detect_overflow_impl_subtraction<
     L, false, is_left_larger,
     R, true, false
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && left < static_cast<L>(right + integer_traits<L>::const_min + right)) {
             result = e_negative_overflow_detected;
@@ -383,7 +542,7 @@ struct detect_overflow_impl_subtraction<
     L, false, is_left_larger,
     R, true, true
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > 0 && right > static_cast<R>(left - integer_traits<L>::const_min)) {
             result = e_negative_overflow_detected;
@@ -399,7 +558,7 @@ struct detect_overflow_impl_subtraction<
     L, true, is_left_larger,
     R, false, false
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left >= 0 && left < static_cast<L>(integer_traits<L>::const_min + right)) {
             result = e_negative_overflow_detected;
@@ -415,7 +574,7 @@ struct detect_overflow_impl_subtraction<
     L, true, is_left_larger,
     R, false, true
 > {
-    static overflow_result detect_overflow_subtraction(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (right > static_cast<R>(left - integer_traits<L>::const_min)) {
             result = e_negative_overflow_detected;
@@ -424,25 +583,38 @@ struct detect_overflow_impl_subtraction<
     }
 };
 
+// Operations on operands narrower than 64 bits are performed once in the next wider
+// native type able to hold any result exactly, then range checked against L without
+// branching on the signs of the operands.
+template <typename L, typename R>
+struct detect_overflow_impl_widened {
+    static std::size_t const operand_size = sizeof(L) > sizeof(R) ? sizeof(L) : sizeof(R);
+    typedef typename widened_int<operand_size, true>::type wide_type;
+    typedef typename widened_int<
+        operand_size,
+        is_signed<L>::value || is_signed<R>::value
+    >::type wide_product_type;
+
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
+        return detect_overflow_range<L>(static_cast<wide_type>(left) + static_cast<wide_type>(right));
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
+        return detect_overflow_range<L>(static_cast<wide_type>(left) - static_cast<wide_type>(right));
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        return detect_overflow_range<L>(static_cast<wide_product_type>(left) * static_cast<wide_product_type>(right));
+    }
+};
+
+// The remaining specializations compare the magnitude of the product against the limit
+// of L in the direction of its sign, so no division is required.
 template <typename L, typename R>
 struct detect_overflow_impl_multiplication<
     L, true,
     R, true
 > {
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
-        overflow_result result = e_no_overflow_detected;
-        if (left != 0 && right != 0) {
-            if ((left ^ right) > 0) {
-                if (abs(right) > abs(integer_traits<L>::const_max / left)) {
-                    result = e_positive_overflow_detected;
-                }
-            } else {
-                if (abs(right) > abs(integer_traits<L>::const_min / left)) {
-                    result = e_negative_overflow_detected;
-                }
-            }
-        }
-        return result;
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        return detect_overflow_magnitude<L>(magnitude_of(left), magnitude_of(right), (left < 0) != (right < 0));
     }
 };
 
@@ -451,14 +623,8 @@ struct detect_overflow_impl_multiplication<
     L, false,
     R, false
 > {
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
-        overflow_result result = e_no_overflow_detected;
-        if (left != 0 && right != 0) {
-            if (right > integer_traits<L>::const_max / left) {
-                result = e_positive_overflow_detected;
-            }
-        }
-        return result;
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        return detect_overflow_magnitude<L>(left, right, false);
     }
 };
 
@@ -467,18 +633,15 @@ struct detect_overflow_impl_multiplication<
     L, false,
     R, true
 > {
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
-        if (left != 0 && right != 0) {
-            if ((left ^ right) > 0) {
-                if (abs(right) > integer_traits<L>::const_max / left) {
-                    result = e_positive_overflow_detected;
-                }
-            } else {
-                if (abs(right) > integer_traits<L>::const_min / left) {
-                    result = e_negative_overflow_detected;
-                }
+        if (right < 0) {
+            // Any non-zero product is negative, which an unsigned L cannot hold.
+            if (left != 0) {
+                result = e_negative_overflow_detected;
             }
+        } else {
+            result = detect_overflow_magnitude<L>(left, static_cast<uint64_t>(right), false);
         }
         return result;
     }
@@ -489,20 +652,8 @@ struct detect_overflow_impl_multiplication<
     L, true,
     R, false
 > {
-    static overflow_result detect_overflow_multiplication(L const left, R const right) {
-        overflow_result result = e_no_overflow_detected;
-        if (left != 0 && right != 0) {
-            if ((left ^ right) > 0) {
-                if (right > integer_traits<L>::const_max / left) {
-                    result = e_positive_overflow_detected;
-                }
-            } else {
-                if (right > integer_traits<L>::const_min / left) {
-                    result = e_negative_overflow_detected;
-                }
-            }
-        }
-        return result;
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        return detect_overflow_magnitude<L>(magnitude_of(left), right, left < 0);
     }
 };
 
@@ -512,7 +663,7 @@ template <
     typename R, bool is_right_signed
 >
 struct detect_overflow_impl_division {
-    static overflow_result detect_overflow_division(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
         (void)left;
         (void)right;
         return e_no_overflow_detected;
@@ -524,7 +675,7 @@ struct detect_overflow_impl_division<
     L, false,
     R, true
 > {
-    static overflow_result detect_overflow_division(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left == integer_traits<L>::const_max && right == -1) {
             result = e_negative_overflow_detected;
@@ -538,7 +689,7 @@ struct detect_overflow_impl_division<
     L, true,
     R, true
 > {
-    static overflow_result detect_overflow_division(L const left, R const right) {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
         overflow_result result = e_no_overflow_detected;
         if (left == integer_traits<L>::const_min && right == -1) {
             result = e_positive_overflow_detected;
@@ -547,9 +698,74 @@ struct detect_overflow_impl_division<
     }
 };
 
+#if defined(BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS)
+// Overflow detection using the compiler intrinsics, which compile to the arithmetic
+// instruction followed by a test of the overflow or carry flag.  The intrinsics only
+// report that the exact result does not fit in L, so the direction of the overflow is
+// recovered from the signs of the operands.
+template <typename L, typename R>
+struct do_detect_overflow_intrinsic {
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_assignment(R const right) {
+        overflow_result result = e_no_overflow_detected;
+        L converted = 0;
+        if (__builtin_add_overflow(right, 0, &converted)) {
+            result = sign_of<R>::is_negative(right) ? e_negative_overflow_detected
+                                                    : e_positive_overflow_detected;
+        }
+        return result;
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_addition(L const left, R const right) {
+        overflow_result result = e_no_overflow_detected;
+        L sum = 0;
+        if (__builtin_add_overflow(left, right, &sum)) {
+            result = sign_of<R>::is_negative(right) ? e_negative_overflow_detected
+                                                    : e_positive_overflow_detected;
+        }
+        return result;
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_subtraction(L const left, R const right) {
+        overflow_result result = e_no_overflow_detected;
+        L difference = 0;
+        if (__builtin_sub_overflow(left, right, &difference)) {
+            result = sign_of<R>::is_negative(right) ? e_positive_overflow_detected
+                                                    : e_negative_overflow_detected;
+        }
+        return result;
+    }
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_multiplication(L const left, R const right) {
+        overflow_result result = e_no_overflow_detected;
+        L product = 0;
+        if (__builtin_mul_overflow(left, right, &product)) {
+            result = sign_of<L>::is_negative(left) != sign_of<R>::is_negative(right)
+                         ? e_negative_overflow_detected
+                         : e_positive_overflow_detected;
+        }
+        return result;
+    }
+    // There is no division intrinsic, and the portable check is already a single comparison.
+    static BOOST_CXX14_CONSTEXPR overflow_result detect_overflow_division(L const left, R const right) {
+        return do_detect_overflow<L, R>::detect_overflow_division(left, right);
+    }
+};
+#endif
+
+// Every operation of verified_int passes its overflow_result to the record_overflow hook of
+// its policy before handling it.  The detection bases inherit this hook, which does nothing.
+// Policies such as counting_overflow hide it to observe overflow.
+struct overflow_record_off
+{
+    template <typename L, typename R>
+    static BOOST_CXX14_CONSTEXPR void record_overflow(overflow_operation const operation,
+                                                      overflow_result const detected)
+    {
+        (void)operation;
+        (void)detected;
+    }
+};
+
 // Base classes for the ignore_overflow.  Allows the compiler
 // to optimize out the call to detect_overflow().
-struct overflow_detection_off
+struct overflow_detection_off : public overflow_record_off
 {
     template <typename L, typename R>
     struct detection
@@ -559,12 +775,27 @@ struct overflow_detection_off
 };
 
 // Base class for all policies except ignore_overflow.
-struct overflow_detection_on
+struct overflow_detection_on : public overflow_record_off
+{
+    template <typename L, typename R>
+    struct detection
+    {
+        typedef do_detect_overflow<L, R> type;
+    };
+};
+
+// Base class for policies detecting overflow with the compiler intrinsics.  Falls back
+// to the portable detection when the compiler does not provide them.
+struct overflow_detection_intrinsic : public overflow_record_off
 {
     template <typename L, typename R>
     struct detection
     {
+#if defined(BOOST_VERIFIED_INT_HAS_OVERFLOW_INTRINSICS)
+        typedef do_detect_overflow_intrinsic<L, R> type;
+#else
         typedef do_detect_overflow<L, R> type;
+#endif
     };
 };
 
@@ -0,0 +1,225 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// parallel_verified_sum sums an array of T, or of verified_int<T, P>, on several threads,
+// with the result and the overflow handling of sequential accumulation with +=:
+//
+//     verified_int64_t const total = parallel_verified_sum(charges, count);
+//
+// Each thread sums a contiguous chunk in a wider type, and also records the lowest and the
+// highest intermediate result of the chunk, relative to the start of the chunk.  These
+// summaries merge associatively, so that the extremes of every intermediate result of the
+// whole array are known exactly, and with them whether sequential accumulation overflows.
+// When it does, the elements from the first chunk which overflows are accumulated again on
+// the calling thread with verified_int<T, P>, so that P handles each overflow exactly where
+// sequential accumulation would.  Policies which do not detect overflow only wrap.
+//
+// Requires C++11.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_PARALLEL_HPP
+#define VERIFIED_INT_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+#include "verified_int_reduce.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_THREAD)
+#  error "verified_int_parallel.hpp requires C++11 <thread>"
+#endif
+
+#if !defined(BOOST_HAS_INT128)
+#  include <boost/multiprecision/cpp_int.hpp>
+#endif
+
+namespace boost {
+
+#if defined(BOOST_HAS_INT128)
+typedef int128_type prefix_wide_type;
+#else
+typedef multiprecision::int128_t prefix_wide_type;
+#endif
+
+// The sum of a sequence, with the lowest and the highest of its intermediate results.  The
+// empty sequence has the single intermediate result zero.
+template <typename W>
+struct prefix_summary
+{
+    W sum;
+    W lowest;
+    W highest;
+
+    prefix_summary() : sum(0), lowest(0), highest(0) {}
+
+    void append(W const value)
+    {
+        sum += value;
+        lowest = sum < lowest ? sum : lowest;
+        highest = sum > highest ? sum : highest;
+    }
+
+    // Appends the sequence summarized by next.
+    template <typename V>
+    void append(prefix_summary<V> const & next)
+    {
+        W const next_lowest = sum + static_cast<W>(next.lowest);
+        W const next_highest = sum + static_cast<W>(next.highest);
+        lowest = next_lowest < lowest ? next_lowest : lowest;
+        highest = next_highest > highest ? next_highest : highest;
+        sum += static_cast<W>(next.sum);
+    }
+
+    // Whether accumulating the sequence from start leaves the range of T.
+    template <typename T>
+    bool overflows(W const start) const
+    {
+        return start + highest > static_cast<W>(integer_traits<T>::const_max) ||
+               start + lowest < static_cast<W>(integer_traits<T>::const_min);
+    }
+};
+
+template <typename T, class P>
+struct parallel_reduction
+{
+    typedef verified_int<T, P> result_type;
+    typedef typename P::template detection<T, T>::type detection_type;
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+    static bool const is_narrow = sizeof(T) < sizeof(int64_t);
+    // Elements summarized in 64 bits before merging into the wide summary of a chunk.  A
+    // block of narrow T cannot overflow 64 bits.
+    static std::size_t const block_size = std::size_t(1) << 20;
+    // Chunks smaller than this are not worth a thread.
+    static std::size_t const minimum_chunk_size = std::size_t(1) << 16;
+
+    // Padded, so that threads do not write to the same cache line.
+    struct chunk
+    {
+        prefix_summary<prefix_wide_type> summary;
+        T wrapped;
+        char padding[64];
+    };
+
+    // Joins every worker started, including when starting the next one throws, so that no
+    // joinable std::thread is destroyed.
+    struct joined_workers
+    {
+        std::vector<std::thread> threads;
+
+        ~joined_workers()
+        {
+            for (std::size_t index = 0; index < threads.size(); ++index) {
+                threads[index].join();
+            }
+        }
+    };
+
+    template <typename E>
+    static void summarize(E const *const values, std::size_t const count, chunk &result)
+    {
+        if (!is_detecting) {
+            T wrapped = 0;
+            for (std::size_t index = 0; index < count; ++index) {
+                wrapped = wrapped_arithmetic<T>::add(wrapped, reduction_value<T>(values[index]));
+            }
+            result.wrapped = wrapped;
+            return;
+        }
+        prefix_summary<prefix_wide_type> summary;
+        if (is_narrow) {
+            for (std::size_t begin = 0; begin < count; begin += block_size) {
+                std::size_t const end = count - begin < block_size ? count : begin + block_size;
+                prefix_summary<int64_t> block;
+                for (std::size_t index = begin; index < end; ++index) {
+                    block.append(static_cast<int64_t>(reduction_value<T>(values[index])));
+                }
+                summary.append(block);
+            }
+        } else {
+            for (std::size_t index = 0; index < count; ++index) {
+                summary.append(static_cast<prefix_wide_type>(reduction_value<T>(values[index])));
+            }
+        }
+        result.summary = summary;
+    }
+
+    template <typename E>
+    static result_type sum(E const *const values, std::size_t const count, unsigned int threads)
+    {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        std::size_t const useful = count / minimum_chunk_size;
+        std::size_t const chunk_count = threads < 1 ? 1 : useful < 1 ? 1 : useful < threads ? useful : threads;
+        std::size_t const chunk_size = (count + chunk_count - 1) / chunk_count;
+
+        std::vector<chunk> chunks(chunk_count);
+        {
+            joined_workers workers;
+            workers.threads.reserve(chunk_count - 1);
+            for (std::size_t index = 1; index < chunk_count; ++index) {
+                std::size_t const begin = index * chunk_size < count ? index * chunk_size : count;
+                std::size_t const size = count - begin < chunk_size ? count - begin : chunk_size;
+                workers.threads.push_back(std::thread(&parallel_reduction::template summarize<E>,
+                                                      values + begin, size, std::ref(chunks[index])));
+            }
+            summarize(values, chunk_count == 1 ? count : chunk_size, chunks[0]);
+        }
+
+        if (!is_detecting) {
+            T wrapped = 0;
+            for (std::size_t index = 0; index < chunk_count; ++index) {
+                wrapped = wrapped_arithmetic<T>::add(wrapped, chunks[index].wrapped);
+            }
+            return result_type(wrapped);
+        }
+        prefix_wide_type start = 0;
+        for (std::size_t index = 0; index < chunk_count; ++index) {
+            if (chunks[index].summary.template overflows<T>(start)) {
+                std::size_t const begin = index * chunk_size;
+                return replay(values + begin, count - begin, static_cast<T>(start));
+            }
+            start += chunks[index].summary.sum;
+        }
+        return result_type(static_cast<T>(start));
+    }
+
+    // Accumulates sequentially from start, which is in range.
+    template <typename E>
+    static BOOST_NOINLINE result_type replay(E const *const values, std::size_t const count, T const start)
+    {
+        result_type accumulated(start);
+        for (std::size_t index = 0; index < count; ++index) {
+            accumulated += reduction_value<T>(values[index]);
+        }
+        return accumulated;
+    }
+};
+
+// Sums count elements on threads threads, or on every hardware thread when threads is zero.
+template <typename T, class P>
+inline verified_int<T, P> parallel_verified_sum(verified_int<T, P> const *const values, std::size_t const count,
+                                                unsigned int const threads = 0)
+{
+    return parallel_reduction<T, P>::sum(values, count, threads);
+}
+
+template <class P, typename T>
+inline verified_int<T, P> parallel_verified_sum(T const *const values, std::size_t const count,
+                                                unsigned int const threads = 0)
+{
+    return parallel_reduction<T, P>::sum(values, count, threads);
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_PARALLEL_HPP
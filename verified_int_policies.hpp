@@ -9,17 +9,33 @@
 
 #include <cassert>
 #include <exception>
+#include <boost/config.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/integer_traits.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 #include "verified_int_overflow_detection.hpp"
 
+// Storage class used for the per-thread state of sticky_overflow.  Without thread local
+// storage the state is shared by all threads.
+#if !defined(BOOST_VERIFIED_INT_THREAD_LOCAL)
+#  if !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+#    define BOOST_VERIFIED_INT_THREAD_LOCAL thread_local
+#  elif defined(__GNUC__)
+#    define BOOST_VERIFIED_INT_THREAD_LOCAL __thread
+#  elif defined(_MSC_VER)
+#    define BOOST_VERIFIED_INT_THREAD_LOCAL __declspec(thread)
+#  else
+#    define BOOST_VERIFIED_INT_THREAD_LOCAL
+#  endif
+#endif
+
 namespace boost {
 
 // This policy is designed to reduce verified_int to a built-in via compiler optimizations.
 struct ignore_overflow : public overflow_detection_off
 {
     template <typename T>
-    static T handle_overflow(T const value, overflow_result const detected)
+    static BOOST_CXX14_CONSTEXPR T handle_overflow(T const value, overflow_result const detected)
     {
         (void)detected;
         return value;
@@ -53,7 +69,7 @@ struct negative_overflow_detected : virtual overflow_detected
 struct throw_overflow : public overflow_detection_on
 {
     template <typename T>
-    static T handle_overflow(T const value, overflow_result const detected)
+    static BOOST_CXX14_CONSTEXPR T handle_overflow(T const value, overflow_result const detected)
     {
         switch (detected)
         {
@@ -71,7 +87,7 @@ struct throw_overflow : public overflow_detection_on
 struct assert_overflow : public overflow_detection_on
 {
     template <typename T>
-    static T handle_overflow(T const value, overflow_result const detected)
+    static BOOST_CXX14_CONSTEXPR T handle_overflow(T const value, overflow_result const detected)
     {
         (void)detected;
         assert(true);
@@ -82,7 +98,7 @@ struct assert_overflow : public overflow_detection_on
 struct saturate_overflow : public overflow_detection_on
 {
     template <typename T>
-    static T handle_overflow(T const value, overflow_result const detected)
+    static BOOST_CXX14_CONSTEXPR T handle_overflow(T const value, overflow_result const detected)
     {
         switch (detected)
         {
@@ -96,6 +112,70 @@ struct saturate_overflow : public overflow_detection_on
         return value;
     }
 };
+
+// Records overflow instead of acting on it.  Each operation ORs its overflow_result into a
+// per-thread status word without branching, and the value wraps as it would for the
+// built-in type.  Check overflowed() once after a batch of operations, for example:
+//
+//     sticky_overflow::clear();
+//     for (...) { total += values[i]; }
+//     if (sticky_overflow::overflowed()) { ... }
+struct sticky_overflow : public overflow_detection_on
+{
+    template <typename T>
+    static T handle_overflow(T const value, overflow_result const detected)
+    {
+        status_word() |= static_cast<unsigned int>(detected);
+        return value;
+    }
+
+    static bool overflowed()
+    {
+        return status_word() != 0;
+    }
+
+    // A combination of e_positive_overflow_detected and e_negative_overflow_detected bits.
+    static unsigned int status()
+    {
+        return status_word();
+    }
+
+    static void clear()
+    {
+        status_word() = 0;
+    }
+
+private:
+    static unsigned int &status_word()
+    {
+        static BOOST_VERIFIED_INT_THREAD_LOCAL unsigned int status = 0;
+        return status;
+    }
+};
+
+// Replaces the overflow detection of Policy, keeping its overflow handling.  For example
+// with_detection<throw_overflow, overflow_detection_intrinsic>.
+template <class Policy, class Detection>
+struct with_detection : public Policy
+{
+    template <typename L, typename R>
+    struct detection
+    {
+        typedef typename Detection::template detection<L, R>::type type;
+    };
+};
+
+// Whether handle_overflow of P returns the wrapped value it is given, so that an operation
+// can be performed first and checked afterwards.  Specialize for such policies.
+template <class P>
+struct wraps_on_overflow : public false_type {};
+
+template <> struct wraps_on_overflow<ignore_overflow> : public true_type {};
+template <> struct wraps_on_overflow<assert_overflow> : public true_type {};
+template <> struct wraps_on_overflow<sticky_overflow> : public true_type {};
+
+template <class Policy, class Detection>
+struct wraps_on_overflow<with_detection<Policy, Detection> > : public wraps_on_overflow<Policy> {};
 } // namespace boost
 
 #endif // VERIFIED_INT_POLICIES_HPP
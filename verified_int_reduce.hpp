@@ -0,0 +1,305 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Reductions over arrays of T or of verified_int<T, P>, returning verified_int<T, P>:
+//
+//     verified_int64_t const total = verified_sum(prices, count);
+//     verified_int<int32_t, saturate_overflow> const energy =
+//         verified_sum_of_squares<saturate_overflow>(samples, count);
+//
+// The result, and every overflow handled by P, is the same as accumulating sequentially
+// from zero with +=, *=, and verified_int<T, P>(left[i]) * right[i] for the dot product.
+// Intermediate results which overflow are therefore detected, even when the final result
+// is in range.
+//
+// The elements are reduced in blocks without branching on overflow.  For integers narrower
+// than 64 bits, the positive and negative terms of a block are summed separately in 64 bits.
+// When neither sum takes the accumulated value out of range, no intermediate result of the
+// block can overflow.  Otherwise the extremes of the intermediate results are tracked in 64
+// bits.  For products and 64-bit integers, each step of the block ors its detected overflow
+// into a flag.  Only a block which overflowed is accumulated again with verified_int<T, P>,
+// so that P handles each overflow exactly where sequential accumulation would.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_REDUCE_HPP
+#define VERIFIED_INT_REDUCE_HPP
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int.hpp"
+#include "verified_int_checked.hpp"
+
+namespace boost {
+
+// The value of an element, which is either a T or a verified_int<T, P>.
+template <typename T, typename E>
+inline T reduction_value(E const element)
+{
+    return static_cast<T>(element);
+}
+
+template <typename T, class P>
+struct verified_reduction
+{
+    typedef verified_int<T, P> result_type;
+    typedef typename P::template detection<T, T>::type detection_type;
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+    static bool const is_narrow = sizeof(T) < sizeof(int64_t);
+    // Elements reduced before checking for overflow.  The sum of a block of terms of a
+    // narrow T fits in 64 bits.
+    static std::size_t const block_size = 256;
+
+    // A product of two narrow T, computed exactly.
+    typedef typename conditional<is_signed<T>::value, int64_t, uint64_t>::type wide_type;
+
+    // ***********************************************
+    // Terms
+    // ***********************************************
+    // Each term returns the value which is accumulated, and ors into detected whether the
+    // term itself overflowed.
+    struct sum_term
+    {
+        template <typename E>
+        static T apply(E const *const left, E const *const right, std::size_t const index, unsigned int &detected) {
+            (void)right;
+            (void)detected;
+            return reduction_value<T>(left[index]);
+        }
+        template <typename E>
+        static void replay(result_type &accumulated, E const *const left, E const *const right, std::size_t const index) {
+            (void)right;
+            accumulated += reduction_value<T>(left[index]);
+        }
+    };
+
+    // The product wraps to T, and overflowed when it differs from the exact product.
+    struct product_term
+    {
+        template <typename E>
+        static T apply(E const *const left, E const *const right, std::size_t const index, unsigned int &detected) {
+            T const left_value = reduction_value<T>(left[index]);
+            T const right_value = reduction_value<T>(right[index]);
+            if (is_narrow) {
+                wide_type const exact = static_cast<wide_type>(left_value) * static_cast<wide_type>(right_value);
+                T const product = static_cast<T>(exact);
+                detected |= static_cast<unsigned int>(static_cast<wide_type>(product) != exact);
+                return product;
+            }
+            detected |= detection_type::detect_overflow_multiplication(left_value, right_value);
+            return wrapped_arithmetic<T>::multiply(left_value, right_value);
+        }
+        template <typename E>
+        static void replay(result_type &accumulated, E const *const left, E const *const right, std::size_t const index) {
+            result_type product(reduction_value<T>(left[index]));
+            product *= reduction_value<T>(right[index]);
+            accumulated += static_cast<T>(product);
+        }
+    };
+
+    // ***********************************************
+    // Blocks
+    // ***********************************************
+    // Sums count terms into accumulated, returning false, and leaving accumulated
+    // unchanged, when an intermediate result may have overflowed.
+    template <class Term, typename E>
+    static bool sum_block(T &accumulated, E const *const left, E const *const right, std::size_t const count)
+    {
+        if (!is_narrow) {
+            return chain_block<Term>(accumulated, left, right, count);
+        }
+        // The terms are in the range of T, so a block of them sums exactly in 64 bits.
+        int64_t positive = 0;
+        int64_t negative = 0;
+        unsigned int detected = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            // Selecting before widening keeps the comparisons in the width of T.
+            T const term = Term::apply(left, right, index, detected);
+            positive += static_cast<int64_t>(sign_of<T>::is_negative(term) ? T(0) : term);
+            negative += static_cast<int64_t>(sign_of<T>::is_negative(term) ? term : T(0));
+        }
+        int64_t const start = static_cast<int64_t>(accumulated);
+        bool const bounded = detected == 0 &&
+            start + positive <= static_cast<int64_t>(integer_traits<T>::const_max) &&
+            start + negative >= static_cast<int64_t>(integer_traits<T>::const_min);
+        if (!is_detecting || bounded) {
+            accumulated = static_cast<T>(start + positive + negative);
+            return true;
+        }
+        // The bound is conservative, so find the extremes of the intermediate results.
+        int64_t running = start;
+        int64_t highest = start;
+        int64_t lowest = start;
+        for (std::size_t index = 0; index < count; ++index) {
+            running += static_cast<int64_t>(Term::apply(left, right, index, detected));
+            highest = running > highest ? running : highest;
+            lowest = running < lowest ? running : lowest;
+        }
+        if (detected != 0 ||
+            highest > static_cast<int64_t>(integer_traits<T>::const_max) ||
+            lowest < static_cast<int64_t>(integer_traits<T>::const_min)) {
+            return false;
+        }
+        accumulated = static_cast<T>(running);
+        return true;
+    }
+
+    template <class Term, typename E>
+    static bool chain_block(T &accumulated, E const *const left, E const *const right, std::size_t const count)
+    {
+        T running = accumulated;
+        unsigned int detected = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            T const term = Term::apply(left, right, index, detected);
+            detected |= detection_type::detect_overflow_addition(running, term);
+            running = wrapped_arithmetic<T>::add(running, term);
+        }
+        if (is_detecting && detected != 0) {
+            return false;
+        }
+        accumulated = running;
+        return true;
+    }
+
+    template <typename E>
+    static bool product_block(T &accumulated, E const *const values, std::size_t const count)
+    {
+        T running = accumulated;
+        unsigned int detected = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            T const value = reduction_value<T>(values[index]);
+            detected |= detection_type::detect_overflow_multiplication(running, value);
+            running = wrapped_arithmetic<T>::multiply(running, value);
+        }
+        if (is_detecting && detected != 0) {
+            return false;
+        }
+        accumulated = running;
+        return true;
+    }
+
+    // ***********************************************
+    // Reductions
+    // ***********************************************
+    template <class Term, typename E>
+    static result_type sum(E const *const left, E const *const right, std::size_t const count)
+    {
+        result_type accumulated;
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            T raw = static_cast<T>(accumulated);
+            // Whole blocks have a constant trip count.
+            bool const summed = size == block_size
+                ? sum_block<Term>(raw, left + begin, right + begin, block_size)
+                : sum_block<Term>(raw, left + begin, right + begin, size);
+            if (summed) {
+                accumulated = raw;
+            } else {
+                replay<Term>(accumulated, left + begin, right + begin, size);
+            }
+        }
+        return accumulated;
+    }
+
+    template <class Term, typename E>
+    static BOOST_NOINLINE void replay(result_type &accumulated, E const *const left, E const *const right,
+                                      std::size_t const count)
+    {
+        for (std::size_t index = 0; index < count; ++index) {
+            Term::replay(accumulated, left, right, index);
+        }
+    }
+
+    template <typename E>
+    static result_type product(E const *const values, std::size_t const count)
+    {
+        result_type accumulated(static_cast<T>(1));
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            std::size_t const size = count - begin < block_size ? count - begin : block_size;
+            T raw = static_cast<T>(accumulated);
+            if (product_block(raw, values + begin, size)) {
+                accumulated = raw;
+            } else {
+                replay_product(accumulated, values + begin, size);
+            }
+        }
+        return accumulated;
+    }
+
+    template <typename E>
+    static BOOST_NOINLINE void replay_product(result_type &accumulated, E const *const values, std::size_t const count)
+    {
+        for (std::size_t index = 0; index < count; ++index) {
+            accumulated *= reduction_value<T>(values[index]);
+        }
+    }
+};
+
+// ***********************************************
+// Reductions of verified_int<T, P>
+// ***********************************************
+template <typename T, class P>
+inline verified_int<T, P> verified_sum(verified_int<T, P> const *const values, std::size_t const count)
+{
+    typedef verified_reduction<T, P> reduction;
+    return reduction::template sum<typename reduction::sum_term>(values, values, count);
+}
+
+template <typename T, class P>
+inline verified_int<T, P> verified_product(verified_int<T, P> const *const values, std::size_t const count)
+{
+    return verified_reduction<T, P>::product(values, count);
+}
+
+template <typename T, class P>
+inline verified_int<T, P> verified_dot(verified_int<T, P> const *const left, verified_int<T, P> const *const right,
+                                       std::size_t const count)
+{
+    typedef verified_reduction<T, P> reduction;
+    return reduction::template sum<typename reduction::product_term>(left, right, count);
+}
+
+template <typename T, class P>
+inline verified_int<T, P> verified_sum_of_squares(verified_int<T, P> const *const values, std::size_t const count)
+{
+    return verified_dot(values, values, count);
+}
+
+// ***********************************************
+// Reductions of T, verified by P
+// ***********************************************
+template <class P, typename T>
+inline verified_int<T, P> verified_sum(T const *const values, std::size_t const count)
+{
+    typedef verified_reduction<T, P> reduction;
+    return reduction::template sum<typename reduction::sum_term>(values, values, count);
+}
+
+template <class P, typename T>
+inline verified_int<T, P> verified_product(T const *const values, std::size_t const count)
+{
+    return verified_reduction<T, P>::product(values, count);
+}
+
+template <class P, typename T>
+inline verified_int<T, P> verified_dot(T const *const left, T const *const right, std::size_t const count)
+{
+    typedef verified_reduction<T, P> reduction;
+    return reduction::template sum<typename reduction::product_term>(left, right, count);
+}
+
+template <class P, typename T>
+inline verified_int<T, P> verified_sum_of_squares(T const *const values, std::size_t const count)
+{
+    return verified_dot<P>(values, values, count);
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_REDUCE_HPP
@@ -0,0 +1,154 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// sharded_verified_int<T, P> is a counter for increments from many threads at once.  Each
+// thread adds to its own shard, in a cache line of its own, so that increments from
+// different threads do not write to the same memory:
+//
+//     sharded_verified_int<uint64_t, throw_overflow> requests;
+//     ++requests;
+//     verified_uint64_t const total = requests.load();
+//
+// A shard is a T.  An increment only checks its own shard, and one which would overflow it
+// first spills the shard into a global atomic_verified_int<T, P>, which handles overflow of
+// the spilled total with P.  load merges the global total and the shards with
+// verified_int<T, P>, so that P handles overflow of the merged total there.  No overflow
+// goes unchecked, but overflow of the total is handled when a shard spills or when the
+// shards are merged, rather than by the increment which caused it.  When an increment
+// throws, the counter is unchanged.  Increments of both signs may therefore take the total
+// out of range and back without P seeing it, and a saturated total is only saturated when
+// loaded.
+//
+// Threads are assigned shards in turn, so that threads share a shard only when there are
+// more threads than Shards.  load is not a snapshot: increments made while it merges may
+// or may not be counted.
+//
+// Requires C++11.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_SHARDED_HPP
+#define VERIFIED_INT_SHARDED_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include "verified_int.hpp"
+#include "verified_int_atomic.hpp"
+#include "verified_int_checked.hpp"
+
+#if defined(BOOST_NO_CXX11_THREAD_LOCAL) || defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#  error "verified_int_sharded.hpp requires C++11 thread_local and <atomic>"
+#endif
+
+namespace boost {
+
+// A number for each thread, assigned in the order in which threads first ask for one.
+struct thread_shard
+{
+    static std::size_t index()
+    {
+        static std::atomic<std::size_t> next(0);
+        static thread_local std::size_t const assigned = next.fetch_add(1, std::memory_order_relaxed);
+        return assigned;
+    }
+};
+
+template <typename T, class P, std::size_t Shards = 64>
+class sharded_verified_int
+{
+public:
+    typedef verified_int<T, P> value_type;
+    typedef typename P::template detection<T, T>::type detection_type;
+    static std::size_t const shard_count = Shards;
+
+    sharded_verified_int()
+    {
+        for (std::size_t index = 0; index < Shards; ++index) {
+            shards_[index].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    sharded_verified_int(sharded_verified_int const &) = delete;
+    sharded_verified_int &operator=(sharded_verified_int const &) = delete;
+
+    // Adds right, which is first verified as a T by P.
+    template <typename R>
+    void add(R const right)
+    {
+        increment(static_cast<T>(value_type(right)));
+    }
+
+    template <typename R>
+    sharded_verified_int &operator+=(R const right)
+    {
+        add(right);
+        return *this;
+    }
+
+    sharded_verified_int &operator++()
+    {
+        increment(T(1));
+        return *this;
+    }
+
+    // The global total plus every shard, with each overflow handled by P.
+    value_type load() const
+    {
+        value_type total = total_.load(std::memory_order_acquire);
+        for (std::size_t index = 0; index < Shards; ++index) {
+            total += shards_[index].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    // Aligned, so that shards do not share a cache line.
+    struct alignas(64) shard
+    {
+        std::atomic<T> value;
+    };
+
+    void increment(T const right)
+    {
+        std::atomic<T> &value = shards_[thread_shard::index() % Shards].value;
+        T current = value.load(std::memory_order_relaxed);
+        while (true) {
+            if (detection_type::detect_overflow_addition(current, right) != e_no_overflow_detected) {
+                spill(value, current);
+                current = value.load(std::memory_order_relaxed);
+                continue;
+            }
+            // Only fails when another thread shares the shard.
+            if (value.compare_exchange_weak(current, wrapped_arithmetic<T>::add(current, right),
+                                            std::memory_order_relaxed, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // Moves spilled out of the shard and into the global total, restoring the shard when
+    // P throws from the global total.
+    BOOST_NOINLINE void spill(std::atomic<T> &value, T const spilled)
+    {
+        value.fetch_sub(spilled, std::memory_order_relaxed);
+        BOOST_TRY {
+            total_.fetch_add(spilled, std::memory_order_release);
+        }
+        BOOST_CATCH (...) {
+            value.fetch_add(spilled, std::memory_order_relaxed);
+            BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+    }
+
+    shard shards_[Shards];
+    atomic_verified_int<T, P> total_;
+};
+} // namespace boost
+
+#endif // VERIFIED_INT_SHARDED_HPP
@@ -0,0 +1,587 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// verified_simd<T, N, P> holds N lanes of T, and verifies +, -, * and conversions lane-wise
+// with the same policies as verified_int.  The operation runs on every lane at once and
+// only reports whether any lane overflowed, so there is a single branch per operation.
+// When a lane has overflowed, each lane is detected again with the detection of P, and
+// P::handle_overflow is applied to the overflowing lanes.  throw_overflow therefore throws
+// if any lane overflowed, and saturate_overflow clamps only the lanes which overflowed.
+//
+// Addition and subtraction of 8, 16 and 32-bit lanes, and multiplication of 16-bit lanes,
+// use SSE2 or AVX2 when the compiler targets them and the lanes fill whole registers.
+// Every other combination uses a branch-free scalar loop, which the compiler may
+// vectorize.  Define BOOST_VERIFIED_INT_NO_SIMD to always use the scalar loop.
+//
+// saturate_add and saturate_sub apply saturate_overflow to whole buffers of 8 and 16-bit
+// integers, using the saturating instructions of SSE2 or AVX2:
+//
+//     saturate_add(mixed, left_channel, right_channel, sample_count);
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_SIMD_HPP
+#define VERIFIED_INT_SIMD_HPP
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include "verified_int_checked.hpp"
+#include "verified_int_overflow_detection.hpp"
+#include "verified_int_policies.hpp"
+
+#if !defined(BOOST_VERIFIED_INT_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define BOOST_VERIFIED_INT_HAS_SSE2
+#  endif
+#  if defined(__SSSE3__) || defined(__AVX__)
+#    include <tmmintrin.h>
+#    define BOOST_VERIFIED_INT_HAS_SSSE3
+#  endif
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#    define BOOST_VERIFIED_INT_HAS_AVX2
+#  endif
+#endif
+
+namespace boost {
+
+// ***********************************************
+// Instruction sets
+// ***********************************************
+// Selects the scalar loop.
+struct simd_scalar
+{
+    static std::size_t const size = 1;
+};
+
+#define GEN_SIMD_INSTRUCTIONS(NAME, VECTOR, PREFIX, BITS) \
+    struct NAME \
+    { \
+        typedef VECTOR vector_type; \
+        static std::size_t const size = BITS / 8; \
+        \
+        static vector_type load(void const *const source) { \
+            return PREFIX##_loadu_si##BITS(static_cast<vector_type const *>(source)); \
+        } \
+        static void store(void *const destination, vector_type const value) { \
+            PREFIX##_storeu_si##BITS(static_cast<vector_type *>(destination), value); \
+        } \
+        static vector_type zero() { return PREFIX##_setzero_si##BITS(); } \
+        static vector_type ones() { return PREFIX##_cmpeq_epi8(zero(), zero()); } \
+        static vector_type bit_or(vector_type const a, vector_type const b) { return PREFIX##_or_si##BITS(a, b); } \
+        static vector_type bit_and(vector_type const a, vector_type const b) { return PREFIX##_and_si##BITS(a, b); } \
+        static vector_type bit_xor(vector_type const a, vector_type const b) { return PREFIX##_xor_si##BITS(a, b); } \
+        /* ~a & b */ \
+        static vector_type and_not(vector_type const a, vector_type const b) { return PREFIX##_andnot_si##BITS(a, b); } \
+        static vector_type add8(vector_type const a, vector_type const b) { return PREFIX##_add_epi8(a, b); } \
+        static vector_type add16(vector_type const a, vector_type const b) { return PREFIX##_add_epi16(a, b); } \
+        static vector_type add32(vector_type const a, vector_type const b) { return PREFIX##_add_epi32(a, b); } \
+        static vector_type sub8(vector_type const a, vector_type const b) { return PREFIX##_sub_epi8(a, b); } \
+        static vector_type sub16(vector_type const a, vector_type const b) { return PREFIX##_sub_epi16(a, b); } \
+        static vector_type sub32(vector_type const a, vector_type const b) { return PREFIX##_sub_epi32(a, b); } \
+        static vector_type adds_i8(vector_type const a, vector_type const b) { return PREFIX##_adds_epi8(a, b); } \
+        static vector_type adds_u8(vector_type const a, vector_type const b) { return PREFIX##_adds_epu8(a, b); } \
+        static vector_type adds_i16(vector_type const a, vector_type const b) { return PREFIX##_adds_epi16(a, b); } \
+        static vector_type adds_u16(vector_type const a, vector_type const b) { return PREFIX##_adds_epu16(a, b); } \
+        static vector_type subs_i8(vector_type const a, vector_type const b) { return PREFIX##_subs_epi8(a, b); } \
+        static vector_type subs_u8(vector_type const a, vector_type const b) { return PREFIX##_subs_epu8(a, b); } \
+        static vector_type subs_i16(vector_type const a, vector_type const b) { return PREFIX##_subs_epi16(a, b); } \
+        static vector_type subs_u16(vector_type const a, vector_type const b) { return PREFIX##_subs_epu16(a, b); } \
+        static vector_type cmpeq8(vector_type const a, vector_type const b) { return PREFIX##_cmpeq_epi8(a, b); } \
+        static vector_type cmpeq16(vector_type const a, vector_type const b) { return PREFIX##_cmpeq_epi16(a, b); } \
+        static vector_type mullo16(vector_type const a, vector_type const b) { return PREFIX##_mullo_epi16(a, b); } \
+        static vector_type mulhi_i16(vector_type const a, vector_type const b) { return PREFIX##_mulhi_epi16(a, b); } \
+        static vector_type mulhi_u16(vector_type const a, vector_type const b) { return PREFIX##_mulhi_epu16(a, b); } \
+        /* Each lane filled with its sign bit. */ \
+        static vector_type sign16(vector_type const a) { return PREFIX##_srai_epi16(a, 15); } \
+        static vector_type sign32(vector_type const a) { return PREFIX##_srai_epi32(a, 31); } \
+        static bool any(vector_type const a) { return PREFIX##_movemask_epi8(a) != 0; } \
+    };
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+GEN_SIMD_INSTRUCTIONS(simd_sse2, __m128i, _mm, 128)
+#endif
+#if defined(BOOST_VERIFIED_INT_HAS_AVX2)
+GEN_SIMD_INSTRUCTIONS(simd_avx2, __m256i, _mm256, 256)
+#endif
+#undef GEN_SIMD_INSTRUCTIONS
+
+// ***********************************************
+// Lane-wise arithmetic
+// ***********************************************
+// Each operation returns the wrapped result, and sets every bit of the lanes which
+// overflowed in overflow.
+template <typename T, class I>
+struct simd_lane_arithmetic
+{
+    static bool const has_add_subtract = false;
+    static bool const has_multiply = false;
+};
+
+// A lane overflowed when the saturating and the wrapping results differ.
+#define GEN_SIMD_SATURATING_LANES(TYPE, BITS, SIGN) \
+    template <class I> \
+    struct simd_lane_arithmetic<TYPE, I> \
+    { \
+        typedef typename I::vector_type vector_type; \
+        static bool const has_add_subtract = true; \
+        static bool const has_multiply = false; \
+        \
+        static vector_type add(vector_type const left, vector_type const right, vector_type &overflow) { \
+            vector_type const sum = I::add##BITS(left, right); \
+            vector_type const equal = I::cmpeq##BITS(sum, I::adds_##SIGN##BITS(left, right)); \
+            overflow = I::bit_or(overflow, I::bit_xor(equal, I::ones())); \
+            return sum; \
+        } \
+        static vector_type subtract(vector_type const left, vector_type const right, vector_type &overflow) { \
+            vector_type const difference = I::sub##BITS(left, right); \
+            vector_type const equal = I::cmpeq##BITS(difference, I::subs_##SIGN##BITS(left, right)); \
+            overflow = I::bit_or(overflow, I::bit_xor(equal, I::ones())); \
+            return difference; \
+        } \
+        static vector_type saturating_add(vector_type const left, vector_type const right) { \
+            return I::adds_##SIGN##BITS(left, right); \
+        } \
+        static vector_type saturating_subtract(vector_type const left, vector_type const right) { \
+            return I::subs_##SIGN##BITS(left, right); \
+        } \
+    };
+GEN_SIMD_SATURATING_LANES(int8_t, 8, i)
+GEN_SIMD_SATURATING_LANES(uint8_t, 8, u)
+GEN_SIMD_SATURATING_LANES(int16_t, 16, i)
+GEN_SIMD_SATURATING_LANES(uint16_t, 16, u)
+#undef GEN_SIMD_SATURATING_LANES
+
+template <class I>
+struct simd_lane_multiplication16
+{
+    typedef typename I::vector_type vector_type;
+    static bool const has_add_subtract = true;
+    static bool const has_multiply = true;
+
+    // The high half of a signed product must be the sign extension of the low half.
+    static vector_type multiply_signed(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const low = I::mullo16(left, right);
+        vector_type const equal = I::cmpeq16(I::mulhi_i16(left, right), I::sign16(low));
+        overflow = I::bit_or(overflow, I::bit_xor(equal, I::ones()));
+        return low;
+    }
+    // The high half of an unsigned product must be zero.
+    static vector_type multiply_unsigned(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const equal = I::cmpeq16(I::mulhi_u16(left, right), I::zero());
+        overflow = I::bit_or(overflow, I::bit_xor(equal, I::ones()));
+        return I::mullo16(left, right);
+    }
+};
+
+template <class I>
+struct simd_lane_arithmetic16_signed : public simd_lane_arithmetic<int16_t, I>, public simd_lane_multiplication16<I>
+{
+    typedef typename I::vector_type vector_type;
+    static bool const has_add_subtract = true;
+    static bool const has_multiply = true;
+    using simd_lane_arithmetic<int16_t, I>::add;
+    using simd_lane_arithmetic<int16_t, I>::subtract;
+    static vector_type multiply(vector_type const left, vector_type const right, vector_type &overflow) {
+        return simd_lane_multiplication16<I>::multiply_signed(left, right, overflow);
+    }
+};
+
+template <class I>
+struct simd_lane_arithmetic16_unsigned : public simd_lane_arithmetic<uint16_t, I>, public simd_lane_multiplication16<I>
+{
+    typedef typename I::vector_type vector_type;
+    static bool const has_add_subtract = true;
+    static bool const has_multiply = true;
+    using simd_lane_arithmetic<uint16_t, I>::add;
+    using simd_lane_arithmetic<uint16_t, I>::subtract;
+    static vector_type multiply(vector_type const left, vector_type const right, vector_type &overflow) {
+        return simd_lane_multiplication16<I>::multiply_unsigned(left, right, overflow);
+    }
+};
+
+// 32-bit lanes have no saturating instructions, so overflow is read from the sign bits.
+template <class I>
+struct simd_lane_arithmetic<int32_t, I>
+{
+    typedef typename I::vector_type vector_type;
+    static bool const has_add_subtract = true;
+    static bool const has_multiply = false;
+
+    // Overflow when both operands differ in sign from the sum.
+    static vector_type add(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const sum = I::add32(left, right);
+        overflow = I::bit_or(overflow, I::sign32(I::bit_and(I::bit_xor(left, sum), I::bit_xor(right, sum))));
+        return sum;
+    }
+    // Overflow when the operands differ in sign, and the difference differs from left.
+    static vector_type subtract(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const difference = I::sub32(left, right);
+        overflow = I::bit_or(overflow,
+            I::sign32(I::bit_and(I::bit_xor(left, right), I::bit_xor(left, difference))));
+        return difference;
+    }
+};
+
+template <class I>
+struct simd_lane_arithmetic<uint32_t, I>
+{
+    typedef typename I::vector_type vector_type;
+    static bool const has_add_subtract = true;
+    static bool const has_multiply = false;
+
+    // The carry out of the top bit is (a & b) | ((a | b) & ~sum).
+    static vector_type add(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const sum = I::add32(left, right);
+        vector_type const carry = I::bit_or(I::bit_and(left, right), I::and_not(sum, I::bit_or(left, right)));
+        overflow = I::bit_or(overflow, I::sign32(carry));
+        return sum;
+    }
+    // The borrow out of the top bit is (~a & b) | (~(a ^ b) & difference).
+    static vector_type subtract(vector_type const left, vector_type const right, vector_type &overflow) {
+        vector_type const difference = I::sub32(left, right);
+        vector_type const borrow = I::bit_or(I::and_not(left, right), I::and_not(I::bit_xor(left, right), difference));
+        overflow = I::bit_or(overflow, I::sign32(borrow));
+        return difference;
+    }
+};
+
+template <typename T, class I>
+struct simd_lanes
+{
+    typedef simd_lane_arithmetic<T, I> type;
+};
+
+template <class I>
+struct simd_lanes<int16_t, I>
+{
+    typedef simd_lane_arithmetic16_signed<I> type;
+};
+
+template <class I>
+struct simd_lanes<uint16_t, I>
+{
+    typedef simd_lane_arithmetic16_unsigned<I> type;
+};
+
+// ***********************************************
+// Operations
+// ***********************************************
+#define GEN_SIMD_OPERATION(NAME, OPERATION, WRAPPED, DETECT_OVERFLOW, LANE_OPERATION, SUPPORT) \
+    struct NAME \
+    { \
+        static overflow_operation const operation = OPERATION; \
+        \
+        template <typename T, class I> \
+        struct is_vectorized \
+        { \
+            static bool const value = simd_lanes<T, I>::type::SUPPORT; \
+        }; \
+        template <typename T, class I> \
+        static typename I::vector_type apply(typename I::vector_type const left, \
+                                             typename I::vector_type const right, \
+                                             typename I::vector_type &overflow) { \
+            return simd_lanes<T, I>::type::LANE_OPERATION(left, right, overflow); \
+        } \
+        template <typename T> \
+        static T wrapped(T const left, T const right) { \
+            return wrapped_arithmetic<T>::WRAPPED(left, right); \
+        } \
+        template <class Detection, typename T> \
+        static overflow_result detect(T const left, T const right) { \
+            return Detection::DETECT_OVERFLOW(left, right); \
+        } \
+    };
+GEN_SIMD_OPERATION(simd_addition, e_addition_operation, add, detect_overflow_addition, add, has_add_subtract)
+GEN_SIMD_OPERATION(simd_subtraction, e_subtraction_operation, subtract, detect_overflow_subtraction, subtract, has_add_subtract)
+GEN_SIMD_OPERATION(simd_multiplication, e_multiplication_operation, multiply, detect_overflow_multiplication, multiply, has_multiply)
+#undef GEN_SIMD_OPERATION
+
+// The widest instruction set whose registers the lanes fill, among those supporting the
+// operation on T.
+template <typename T, std::size_t N, class Operation>
+struct simd_instructions
+{
+    typedef simd_scalar sse2_type;
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+    typedef typename conditional<
+        Operation::template is_vectorized<T, simd_sse2>::value && (N * sizeof(T)) % simd_sse2::size == 0,
+        simd_sse2,
+        simd_scalar
+    >::type sse2_or_scalar;
+#else
+    typedef simd_scalar sse2_or_scalar;
+#endif
+#if defined(BOOST_VERIFIED_INT_HAS_AVX2)
+    typedef typename conditional<
+        Operation::template is_vectorized<T, simd_avx2>::value && (N * sizeof(T)) % simd_avx2::size == 0,
+        simd_avx2,
+        sse2_or_scalar
+    >::type type;
+#else
+    typedef sse2_or_scalar type;
+#endif
+};
+
+// Computes every lane into result, and returns whether any lane overflowed.
+template <typename T, std::size_t N, class Detection, class Operation, class I>
+struct simd_kernel
+{
+    static bool apply(T const *const left, T const *const right, T *const result) {
+        typename I::vector_type overflow = I::zero();
+        char const *const left_bytes = reinterpret_cast<char const *>(left);
+        char const *const right_bytes = reinterpret_cast<char const *>(right);
+        char *const result_bytes = reinterpret_cast<char *>(result);
+        for (std::size_t offset = 0; offset < N * sizeof(T); offset += I::size) {
+            I::store(result_bytes + offset, Operation::template apply<T, I>(
+                I::load(left_bytes + offset), I::load(right_bytes + offset), overflow));
+        }
+        return I::any(overflow);
+    }
+};
+
+template <typename T, std::size_t N, class Detection, class Operation>
+struct simd_kernel<T, N, Detection, Operation, simd_scalar>
+{
+    static bool apply(T const *const left, T const *const right, T *const result) {
+        unsigned int detected = e_no_overflow_detected;
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            detected |= Operation::template detect<Detection>(left[lane], right[lane]);
+            result[lane] = Operation::wrapped(left[lane], right[lane]);
+        }
+        return detected != e_no_overflow_detected;
+    }
+};
+
+template <typename T, std::size_t N, class P>
+class verified_simd
+{
+    BOOST_STATIC_ASSERT(N > 0);
+
+    typedef typename P::template detection<T, T>::type detection_type;
+    // Policies which do not detect overflow, such as ignore_overflow, only wrap.
+    static bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, T> >::value;
+
+public:
+    typedef T value_type;
+    static std::size_t const size = N;
+
+    // Every lane zero.
+    verified_simd() : lanes_()
+    {
+    }
+
+    // Every lane value.
+    explicit verified_simd(T const value)
+    {
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            lanes_[lane] = value;
+        }
+    }
+
+    // Lane-wise conversion from another verified_simd, verified by P.
+    template <typename U, class Q>
+    explicit verified_simd(verified_simd<U, N, Q> const & other)
+    {
+        U values[N];
+        other.store(values);
+        assign(values);
+    }
+
+    // Lane-wise conversion from N values, verified by P.
+    template <typename U>
+    static verified_simd load(U const *const values)
+    {
+        verified_simd loaded;
+        loaded.assign(values);
+        return loaded;
+    }
+
+    void store(T *const values) const
+    {
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            values[lane] = lanes_[lane];
+        }
+    }
+
+    T operator[](std::size_t const lane) const
+    {
+        return lanes_[lane];
+    }
+
+    verified_simd & operator+=(verified_simd const & right)
+    {
+        apply<simd_addition>(right);
+        return *this;
+    }
+
+    verified_simd & operator-=(verified_simd const & right)
+    {
+        apply<simd_subtraction>(right);
+        return *this;
+    }
+
+    verified_simd & operator*=(verified_simd const & right)
+    {
+        apply<simd_multiplication>(right);
+        return *this;
+    }
+
+private:
+    template <class Operation>
+    void apply(verified_simd const & right)
+    {
+        typedef typename conditional<
+            is_detecting,
+            typename simd_instructions<T, N, Operation>::type,
+            simd_scalar
+        >::type instructions;
+        T result[N];
+        if (simd_kernel<T, N, detection_type, Operation, instructions>::apply(lanes_, right.lanes_, result)) {
+            handle_lanes<Operation>(right, result);
+        }
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            lanes_[lane] = result[lane];
+        }
+    }
+
+    // Detects each lane again, and lets the policy handle the ones which overflowed.
+    template <class Operation>
+    BOOST_NOINLINE void handle_lanes(verified_simd const & right, T *const result) const
+    {
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            overflow_result const detected = Operation::template detect<detection_type>(lanes_[lane], right.lanes_[lane]);
+            P::template record_overflow<T, T>(Operation::operation, detected);
+            if (detected != e_no_overflow_detected) {
+                result[lane] = P::handle_overflow(result[lane], detected);
+            }
+        }
+    }
+
+    template <typename U>
+    void assign(U const *const values)
+    {
+        typedef typename P::template detection<T, U>::type assignment_type;
+        unsigned int detected = e_no_overflow_detected;
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            detected |= assignment_type::detect_overflow_assignment(values[lane]);
+            lanes_[lane] = static_cast<T>(values[lane]);
+        }
+        if (detected != e_no_overflow_detected) {
+            handle_assignment(values);
+        }
+    }
+
+    template <typename U>
+    BOOST_NOINLINE void handle_assignment(U const *const values)
+    {
+        typedef typename P::template detection<T, U>::type assignment_type;
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            overflow_result const detected = assignment_type::detect_overflow_assignment(values[lane]);
+            P::template record_overflow<T, U>(e_assignment_operation, detected);
+            if (detected != e_no_overflow_detected) {
+                lanes_[lane] = P::handle_overflow(lanes_[lane], detected);
+            }
+        }
+    }
+
+    T lanes_[N];
+};
+
+// ***********************************************
+// Binary math operators
+// ***********************************************
+// Both operands must share the lane type, the lane count and the policy.
+#define GEN_BINARY_OPERATORS_SIMD(OPERATOR_MATH, MATH_ASSIGN) \
+    template <typename T, std::size_t N, class P> \
+    verified_simd<T, N, P> OPERATOR_MATH( \
+            verified_simd<T, N, P> const & left, \
+            verified_simd<T, N, P> const & right) \
+    { \
+        verified_simd<T, N, P> copied_simd(left); \
+        copied_simd MATH_ASSIGN right; \
+        return copied_simd; \
+    }
+GEN_BINARY_OPERATORS_SIMD(operator+, +=)
+GEN_BINARY_OPERATORS_SIMD(operator-, -=)
+GEN_BINARY_OPERATORS_SIMD(operator*, *=)
+#undef GEN_BINARY_OPERATORS_SIMD
+
+// ***********************************************
+// Saturating buffers
+// ***********************************************
+#define GEN_SIMD_SATURATING_OPERATION(NAME, LANE_OPERATION, CHECKED_OPERATION) \
+    struct NAME \
+    { \
+        template <typename T, class I> \
+        static typename I::vector_type apply(typename I::vector_type const left, \
+                                             typename I::vector_type const right) { \
+            return simd_lane_arithmetic<T, I>::LANE_OPERATION(left, right); \
+        } \
+        template <typename T> \
+        static T apply(T const left, T const right) { \
+            checked_result<T> const result = checked_arithmetic<saturate_overflow>::CHECKED_OPERATION(left, right); \
+            return saturate_overflow::handle_overflow(result.value, result.result); \
+        } \
+    };
+GEN_SIMD_SATURATING_OPERATION(simd_saturating_addition, saturating_add, add)
+GEN_SIMD_SATURATING_OPERATION(simd_saturating_subtraction, saturating_subtract, subtract)
+#undef GEN_SIMD_SATURATING_OPERATION
+
+// Saturates the elements from index while whole registers remain, returning the index of
+// the first element left over.
+template <class I, class Operation, typename T>
+inline std::size_t saturate_registers(T *const destination, T const *const left, T const *const right,
+                                      std::size_t index, std::size_t const count)
+{
+    std::size_t const lanes = I::size / sizeof(T);
+    for (; count - index >= lanes; index += lanes) {
+        I::store(destination + index, Operation::template apply<T, I>(I::load(left + index), I::load(right + index)));
+    }
+    return index;
+}
+
+template <class Operation, typename T>
+inline void saturate_buffer(T *const destination, T const *const left, T const *const right, std::size_t const count)
+{
+    std::size_t index = 0;
+#if defined(BOOST_VERIFIED_INT_HAS_AVX2)
+    index = saturate_registers<simd_avx2, Operation>(destination, left, right, index, count);
+#endif
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+    index = saturate_registers<simd_sse2, Operation>(destination, left, right, index, count);
+#endif
+    for (; index < count; ++index) {
+        destination[index] = Operation::apply(left[index], right[index]);
+    }
+}
+
+// destination[i] = left[i] + right[i] and left[i] - right[i] for each of count elements,
+// saturating exactly as verified_int<T, saturate_overflow> does.  destination may be left
+// or right, but must not otherwise overlap them.
+#define GEN_SATURATE_BUFFERS(TYPE) \
+    inline void saturate_add(TYPE *const destination, TYPE const *const left, TYPE const *const right, \
+                             std::size_t const count) \
+    { \
+        saturate_buffer<simd_saturating_addition>(destination, left, right, count); \
+    } \
+    inline void saturate_sub(TYPE *const destination, TYPE const *const left, TYPE const *const right, \
+                             std::size_t const count) \
+    { \
+        saturate_buffer<simd_saturating_subtraction>(destination, left, right, count); \
+    }
+GEN_SATURATE_BUFFERS(int8_t)
+GEN_SATURATE_BUFFERS(uint8_t)
+GEN_SATURATE_BUFFERS(int16_t)
+GEN_SATURATE_BUFFERS(uint16_t)
+#undef GEN_SATURATE_BUFFERS
+
+} // namespace boost
+
+#endif // VERIFIED_INT_SIMD_HPP
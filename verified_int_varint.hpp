@@ -0,0 +1,367 @@
+//               Copyright Ben Robinson 2011.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//! \brief
+// Encodes verified_int<T, P> as LEB128 varints, as Protocol Buffers does, and decodes varints
+// directly into verified_int<T, P>:
+//
+//     uint8_t buffer[max_varint_size];
+//     uint8_t *const end = encode_varint(buffer, buffer + sizeof(buffer), quantity).ptr;
+//
+//     verified_uint32_t field;
+//     verified_decode_result const decoded = decode_varint(first, last, field);
+//     if (decoded.ptr == first) { ... }  // Truncated.
+//
+// A varint holds 64 bits, seven in each byte, the lowest first, with the high bit of each
+// byte but the last set.  Signed integers are sign-extended to 64 bits by encode_varint, so
+// that a negative number takes ten bytes, and encode_zigzag maps signed integers of small
+// magnitude to small varints.
+//
+// Decoding reads the 64 bits and assigns them to T, as int64_t for signed T and as uint64_t
+// for unsigned T, so that a varint out of the range of T is an assignment overflow which is
+// recorded and handled by P and returned in result.  A varint of more than ten bytes, or of
+// ten bytes with more than 64 bits, is over-long, and is handled as an
+// e_positive_overflow_detected of its low 64 bits.  ptr points past the last byte, even when
+// the varint overflows, and is first when the last byte is missing, in which case value is
+// unchanged.
+//
+// decode_packed_varints and decode_packed_zigzags decode a packed repeated field, with SSE2
+// finding the last byte of each varint sixteen bytes at a time where the compiler targets
+// it.  Define BOOST_VERIFIED_INT_NO_SIMD to decode one byte at a time.
+//----------------------------------------------------------------------------
+
+#ifndef VERIFIED_INT_VARINT_HPP
+#define VERIFIED_INT_VARINT_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include "verified_int.hpp"
+#include "verified_int_simd.hpp"
+
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+namespace boost {
+
+// The longest varint, of 64 bits.
+std::size_t const max_varint_size = 10;
+
+struct verified_decode_result
+{
+    uint8_t const *ptr;
+    overflow_result result;
+};
+
+struct verified_encode_result
+{
+    uint8_t *ptr;
+    bool fits;
+};
+
+struct verified_packed_decode_result
+{
+    uint8_t const *ptr;
+    std::size_t count;
+};
+
+// ***********************************************
+// Encodings
+// ***********************************************
+// The int32, int64, uint32 and uint64 fields of Protocol Buffers.
+struct varint_encoding
+{
+    template <typename T>
+    struct wire
+    {
+        typedef typename conditional<is_signed<T>::value, int64_t, uint64_t>::type type;
+    };
+
+    template <typename T>
+    static uint64_t encode(T const value)
+    {
+        return static_cast<uint64_t>(static_cast<typename wire<T>::type>(value));
+    }
+
+    template <typename T>
+    static typename wire<T>::type decode(uint64_t const bits)
+    {
+        return static_cast<typename wire<T>::type>(bits);
+    }
+};
+
+// The sint32 and sint64 fields of Protocol Buffers: 0, -1, 1, -2, ... are encoded as
+// 0, 1, 2, 3, ...
+struct zigzag_encoding
+{
+    template <typename T>
+    struct wire
+    {
+        BOOST_STATIC_ASSERT_MSG(is_signed<T>::value, "zigzag encodes signed integers");
+        typedef int64_t type;
+    };
+
+    template <typename T>
+    static uint64_t encode(T const value)
+    {
+        uint64_t const bits = static_cast<uint64_t>(static_cast<typename wire<T>::type>(value));
+        return (bits << 1) ^ (0 - (bits >> 63));
+    }
+
+    template <typename T>
+    static typename wire<T>::type decode(uint64_t const bits)
+    {
+        return static_cast<typename wire<T>::type>((bits >> 1) ^ (0 - (bits & 1)));
+    }
+};
+
+// ***********************************************
+// Bytes
+// ***********************************************
+// Reads the varint at first, returning past its last byte, or first when its last byte is
+// not before last.
+inline uint8_t const *read_varint(uint8_t const *const first, uint8_t const *const last,
+                                  uint64_t &bits, bool &overlong)
+{
+    uint64_t value = 0;
+    unsigned int shift = 0;
+    for (uint8_t const *position = first; position != last; ++position) {
+        uint64_t const byte = *position;
+        if (shift < 64) {
+            value |= (byte & 0x7F) << shift;
+        }
+        if (byte < 0x80) {
+            bits = value;
+            overlong = shift > 63 || (shift == 63 && byte > 1);
+            return position + 1;
+        }
+        // Stops counting past the longest varint, so that the shift cannot wrap.
+        shift = shift < 64 ? shift + 7 : shift;
+    }
+    return first;
+}
+
+// The number of bytes of the varint of bits.
+inline std::size_t varint_size(uint64_t bits)
+{
+    std::size_t size = 1;
+    while (bits >= 0x80) {
+        bits >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+// Assigns bits, decoded by Encoding, to value, with P handling overflow.
+template <class Encoding, typename T, class P>
+inline overflow_result assign_varint(verified_int<T, P> &value, uint64_t const bits, bool const overlong)
+{
+    typedef typename Encoding::template wire<T>::type wire_type;
+    typedef typename P::template detection<T, wire_type>::type detection_type;
+    bool const is_detecting = !is_same<detection_type, do_not_detect_overflow<T, wire_type> >::value;
+
+    wire_type const decoded = Encoding::template decode<T>(bits);
+    overflow_result detected = e_no_overflow_detected;
+    if (is_detecting) {
+        detected = overlong ? e_positive_overflow_detected : detection_type::detect_overflow_assignment(decoded);
+    }
+    P::template record_overflow<T, wire_type>(e_assignment_operation, detected);
+    value = verified_int<T, P>(P::handle_overflow(static_cast<T>(decoded), detected));
+    return detected;
+}
+
+template <class Encoding, typename T, class P>
+inline verified_encode_result encode_verified_int(uint8_t *const first, uint8_t *const last,
+                                                  verified_int<T, P> const value)
+{
+    uint64_t bits = Encoding::encode(static_cast<T>(value));
+    if (static_cast<std::size_t>(last - first) < max_varint_size &&
+        static_cast<std::size_t>(last - first) < varint_size(bits)) {
+        verified_encode_result const too_long = { last, false };
+        return too_long;
+    }
+    uint8_t *position = first;
+    while (bits >= 0x80) {
+        *position++ = static_cast<uint8_t>(bits | 0x80);
+        bits >>= 7;
+    }
+    *position++ = static_cast<uint8_t>(bits);
+    verified_encode_result const encoded = { position, true };
+    return encoded;
+}
+
+template <class Encoding, typename T, class P>
+inline verified_decode_result decode_verified_int(uint8_t const *const first, uint8_t const *const last,
+                                                  verified_int<T, P> &value)
+{
+    uint64_t bits;
+    bool overlong = false;
+    uint8_t const *end;
+    if (first != last && *first < 0x80) {
+        bits = *first;
+        end = first + 1;
+    } else {
+        end = read_varint(first, last, bits, overlong);
+        if (end == first) {
+            verified_decode_result const none = { first, e_no_overflow_detected };
+            return none;
+        }
+    }
+    verified_decode_result const decoded = { end, assign_varint<Encoding>(value, bits, overlong) };
+    return decoded;
+}
+
+// ***********************************************
+// Packed repeated fields
+// ***********************************************
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+// The index of the lowest set bit of a mask which is not zero.
+inline unsigned int lowest_set_bit(unsigned int const mask)
+{
+#  if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#  elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned int>(index);
+#  else
+    unsigned int index = 0;
+    while ((mask >> index & 1U) == 0) {
+        ++index;
+    }
+    return index;
+#  endif
+}
+
+// Gathers the seven-bit groups of a varint of up to eight bytes, which are the low bytes of
+// word, into the low 56 bits.
+inline uint64_t gather_varint(uint64_t word)
+{
+    word &= 0x7F7F7F7F7F7F7F7FULL;
+    word = ((word & 0x7F007F007F007F00ULL) >> 1) | (word & 0x007F007F007F007FULL);
+    word = ((word & 0x3FFF00003FFF0000ULL) >> 2) | (word & 0x00003FFF00003FFFULL);
+    return ((word & 0x0FFFFFFF00000000ULL) >> 4) | (word & 0x000000000FFFFFFFULL);
+}
+#endif
+
+template <class Encoding, typename T, class P>
+inline verified_packed_decode_result decode_packed(uint8_t const *const first, uint8_t const *const last,
+                                                   verified_int<T, P> *const destination,
+                                                   std::size_t const capacity)
+{
+    uint8_t const *position = first;
+    std::size_t count = 0;
+#if defined(BOOST_VERIFIED_INT_HAS_SSE2)
+    // Sixteen bytes hold at most sixteen varints.  The bytes are copied into block, followed
+    // by zeros, so that eight bytes may be read from any of them.
+    uint8_t block[24] = { 0 };
+    while (last - position >= 16 && capacity - count >= 16) {
+        __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(position));
+        unsigned int const continued = static_cast<unsigned int>(_mm_movemask_epi8(bytes));
+        if (continued == 0) {
+            for (std::size_t index = 0; index < 16; ++index) {
+                assign_varint<Encoding>(destination[count + index], position[index], false);
+            }
+            position += 16;
+            count += 16;
+            continue;
+        }
+        unsigned int ends = ~continued & 0xFFFFU;
+        if (ends == 0) {
+            // A varint of more than sixteen bytes, which is over-long.
+            uint8_t const *const end = decode_verified_int<Encoding>(position, last, destination[count]).ptr;
+            if (end == position) {
+                break;
+            }
+            position = end;
+            ++count;
+            continue;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block), bytes);
+        unsigned int start = 0;
+        do {
+            unsigned int const end = lowest_set_bit(ends);
+            ends &= ends - 1;
+            if (end - start < 8) {
+                uint64_t word;
+                std::memcpy(&word, block + start, sizeof(word));
+                word &= ~uint64_t(0) >> (8 * (7 - (end - start)));
+                assign_varint<Encoding>(destination[count], gather_varint(word), false);
+            } else {
+                decode_verified_int<Encoding>(position + start, last, destination[count]);
+            }
+            ++count;
+            start = end + 1;
+        } while (ends != 0);
+        position += start;
+    }
+#endif
+    while (position != last && count != capacity) {
+        uint8_t const *const end = decode_verified_int<Encoding>(position, last, destination[count]).ptr;
+        if (end == position) {
+            break;
+        }
+        position = end;
+        ++count;
+    }
+    verified_packed_decode_result const decoded = { position, count };
+    return decoded;
+}
+
+// ***********************************************
+// Varints and zigzag varints
+// ***********************************************
+template <typename T, class P>
+inline verified_encode_result encode_varint(uint8_t *const first, uint8_t *const last, verified_int<T, P> const value)
+{
+    return encode_verified_int<varint_encoding>(first, last, value);
+}
+
+template <typename T, class P>
+inline verified_encode_result encode_zigzag(uint8_t *const first, uint8_t *const last, verified_int<T, P> const value)
+{
+    return encode_verified_int<zigzag_encoding>(first, last, value);
+}
+
+template <typename T, class P>
+inline verified_decode_result decode_varint(uint8_t const *const first, uint8_t const *const last,
+                                            verified_int<T, P> &value)
+{
+    return decode_verified_int<varint_encoding>(first, last, value);
+}
+
+template <typename T, class P>
+inline verified_decode_result decode_zigzag(uint8_t const *const first, uint8_t const *const last,
+                                            verified_int<T, P> &value)
+{
+    return decode_verified_int<zigzag_encoding>(first, last, value);
+}
+
+// Decodes varints into destination until last, until capacity varints are decoded, or
+// until a varint is truncated, returning past the last varint decoded and their count.
+template <typename T, class P>
+inline verified_packed_decode_result decode_packed_varints(uint8_t const *const first, uint8_t const *const last,
+                                                           verified_int<T, P> *const destination,
+                                                           std::size_t const capacity)
+{
+    return decode_packed<varint_encoding>(first, last, destination, capacity);
+}
+
+template <typename T, class P>
+inline verified_packed_decode_result decode_packed_zigzags(uint8_t const *const first, uint8_t const *const last,
+                                                           verified_int<T, P> *const destination,
+                                                           std::size_t const capacity)
+{
+    return decode_packed<zigzag_encoding>(first, last, destination, capacity);
+}
+} // namespace boost
+
+#endif // VERIFIED_INT_VARINT_HPP